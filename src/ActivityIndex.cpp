@@ -0,0 +1,618 @@
+// Copyright (c) 2019 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "ActivityIndex.hpp"
+
+#include <opentxs/opentxs.hpp>
+
+#include "ActivityStore.hpp"
+#include "MappedFile.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <unordered_map>
+
+#define ACTIVITY_INDEX_VERSION 1
+#define ACTIVITY_INDEX_BLOCK 4096
+
+namespace fs = boost::filesystem;
+namespace po = boost::program_options;
+
+namespace
+{
+const char magic_[] = {'O', 'T', 'C', 'T', 'L', 'C', 'O', 'L'};
+
+enum Column : std::size_t {
+    Time = 0,
+    Amount,
+    Pending,
+    Type,
+    Account,
+    Workflow,
+    Contact,
+    Live,
+    MemoOffsets,
+    MemoHeap,
+    AccountOffsets,
+    AccountHeap,
+    WorkflowOffsets,
+    WorkflowHeap,
+    ContactOffsets,
+    ContactHeap,
+    Columns,
+};
+
+// magic, version, column count, rows, source size, {offset, size} per column
+constexpr std::size_t header_size_{
+    sizeof(magic_) + 2 * sizeof(std::uint32_t) + 2 * sizeof(std::uint64_t) +
+    Columns * 2 * sizeof(std::uint64_t)};
+
+template <typename T>
+void append(std::string& out, const T value)
+{
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+T extract(const std::uint8_t* in)
+{
+    T output{};
+    std::memcpy(&output, in, sizeof(output));
+
+    return output;
+}
+
+template <typename T>
+std::string bytes(const std::vector<T>& in)
+{
+    return std::string(
+        reinterpret_cast<const char*>(in.data()), in.size() * sizeof(T));
+}
+
+// Strings stored once, in order of first appearance
+class Interner
+{
+public:
+    std::uint32_t Add(const std::string& value)
+    {
+        const auto [it, added] = index_.emplace(
+            value, static_cast<std::uint32_t>(offsets_.size() - 1));
+
+        if (added) {
+            heap_.append(value);
+            offsets_.emplace_back(heap_.size());
+        }
+
+        return it->second;
+    }
+
+    std::string Heap() const { return heap_; }
+    std::string Offsets() const { return bytes(offsets_); }
+
+    Interner()
+        : index_()
+        , offsets_(1, 0)
+        , heap_()
+    {
+    }
+
+private:
+    std::unordered_map<std::string, std::uint32_t> index_;
+    std::vector<std::uint64_t> offsets_;
+    std::string heap_;
+};
+
+std::uint64_t source_size(const std::string& store)
+{
+    boost::system::error_code ec{};
+    const auto output = fs::file_size(store, ec);
+
+    return ec ? 0 : static_cast<std::uint64_t>(output);
+}
+}  // namespace
+
+namespace opentxs::otctl
+{
+std::string_view ActivityIndex::Dictionary::at(const std::size_t index) const
+{
+    return std::string_view(
+        heap_ + offsets_[index],
+        static_cast<std::size_t>(offsets_[index + 1] - offsets_[index]));
+}
+
+std::size_t ActivityIndex::Dictionary::find(const std::string& value) const
+{
+    for (std::size_t i{0}; i < size_; ++i) {
+        if (at(i) == value) { return i; }
+    }
+
+    return size_;
+}
+
+ActivityIndex::ActivityIndex(const std::string& path)
+    : file_(std::make_unique<MappedFile>(path))
+    , good_(false)
+    , rows_(0)
+    , source_(0)
+    , time_(nullptr)
+    , amount_(nullptr)
+    , pending_(nullptr)
+    , type_(nullptr)
+    , account_(nullptr)
+    , workflow_(nullptr)
+    , contact_(nullptr)
+    , live_(nullptr)
+    , memo_()
+    , accounts_()
+    , workflows_()
+    , contacts_()
+{
+    const auto& file = *file_;
+
+    if ((false == file.good()) || (header_size_ > file.size()) ||
+        (0 != std::memcmp(file.data(), magic_, sizeof(magic_))) ||
+        (ACTIVITY_INDEX_VERSION != extract<std::uint32_t>(file.data() + 8)) ||
+        (Columns != extract<std::uint32_t>(file.data() + 12))) {
+        return;
+    }
+
+    rows_ = static_cast<std::size_t>(extract<std::uint64_t>(file.data() + 16));
+    source_ = extract<std::uint64_t>(file.data() + 24);
+    const auto* descriptors = file.data() + 32;
+    std::vector<const std::uint8_t*> columns(Columns, nullptr);
+    std::vector<std::size_t> sizes(Columns, 0);
+
+    for (std::size_t i{0}; i < Columns; ++i) {
+        const auto offset = extract<std::uint64_t>(descriptors + 16 * i);
+        const auto size = extract<std::uint64_t>(descriptors + 16 * i + 8);
+
+        // Columns are read in place, so they must be aligned
+        if ((0 != offset % 8) || (offset > file.size()) ||
+            (size > file.size() - offset)) {
+            return;
+        }
+
+        columns[i] = file.data() + offset;
+        sizes[i] = static_cast<std::size_t>(size);
+    }
+
+    // A truncated or foreign file must never lead to reads past a column
+    const auto fixed = [&](Column column, std::size_t width) {
+        return (rows_ <= file.size()) && (rows_ * width == sizes[column]);
+    };
+    bool valid = fixed(Time, sizeof(std::int64_t)) &&
+                 fixed(Amount, sizeof(std::int64_t)) &&
+                 fixed(Pending, sizeof(std::int64_t)) &&
+                 fixed(Type, sizeof(std::int32_t)) &&
+                 fixed(Account, sizeof(std::uint32_t)) &&
+                 fixed(Workflow, sizeof(std::uint32_t)) &&
+                 fixed(Contact, sizeof(std::uint32_t)) &&
+                 fixed(Live, sizeof(std::uint8_t));
+    const auto dictionary = [&](Column offsets, Column heap) {
+        Dictionary output{};
+        const auto count = sizes[offsets] / sizeof(std::uint64_t);
+
+        if ((0 == count) || (0 != sizes[offsets] % sizeof(std::uint64_t))) {
+            valid = false;
+
+            return output;
+        }
+
+        output.offsets_ =
+            reinterpret_cast<const std::uint64_t*>(columns[offsets]);
+        output.heap_ = reinterpret_cast<const char*>(columns[heap]);
+        output.size_ = count - 1;
+
+        for (std::size_t i{0}; i < output.size_; ++i) {
+            if (output.offsets_[i] > output.offsets_[i + 1]) { valid = false; }
+        }
+
+        if (output.offsets_[output.size_] > sizes[heap]) { valid = false; }
+
+        return output;
+    };
+
+    if (false == valid) { return; }
+
+    memo_ = dictionary(MemoOffsets, MemoHeap);
+    accounts_ = dictionary(AccountOffsets, AccountHeap);
+    workflows_ = dictionary(WorkflowOffsets, WorkflowHeap);
+    contacts_ = dictionary(ContactOffsets, ContactHeap);
+
+    if ((false == valid) || (rows_ != memo_.size_)) { return; }
+
+    time_ = reinterpret_cast<const std::int64_t*>(columns[Time]);
+    amount_ = reinterpret_cast<const std::int64_t*>(columns[Amount]);
+    pending_ = reinterpret_cast<const std::int64_t*>(columns[Pending]);
+    type_ = reinterpret_cast<const std::int32_t*>(columns[Type]);
+    account_ = reinterpret_cast<const std::uint32_t*>(columns[Account]);
+    workflow_ = reinterpret_cast<const std::uint32_t*>(columns[Workflow]);
+    contact_ = reinterpret_cast<const std::uint32_t*>(columns[Contact]);
+    live_ = columns[Live];
+
+    // Checked once here so that Scan can index the dictionaries unchecked
+    for (std::size_t row{0}; row < rows_; ++row) {
+        if ((account_[row] >= accounts_.size_) ||
+            (workflow_[row] >= workflows_.size_) ||
+            (contact_[row] >= contacts_.size_)) {
+            return;
+        }
+    }
+
+    good_ = true;
+}
+
+bool ActivityIndex::Build(const std::string& store, const std::string& index)
+{
+    const auto source = source_size(store);
+
+    {
+        // An index which fails validation, for example one written by another
+        // version, is rebuilt like a stale one
+        const ActivityIndex existing(index);
+
+        if (existing.good() && (source == existing.source_)) { return true; }
+    }
+
+    std::vector<std::int64_t> time{}, amount{}, pending{};
+    std::vector<std::int32_t> type{};
+    std::vector<std::uint32_t> account{}, workflow{}, contact{};
+    std::vector<std::uint8_t> live{};
+    std::vector<std::uint64_t> memoOffsets(1, 0);
+    std::string memoHeap{};
+    Interner accounts{}, workflows{}, contacts{};
+    std::unordered_map<std::string, std::size_t> latest{};
+
+    const auto read = ActivityStore::Read(
+        store, [&](const proto::AccountEvent& event) {
+            const auto row = time.size();
+            const auto [it, added] = latest.emplace(
+                event.id() + '/' + ActivityStore::Key(event), row);
+
+            // A newer version of an event replaces the older one
+            if (false == added) {
+                live.at(it->second) = 0;
+                it->second = row;
+            }
+
+            time.emplace_back(event.timestamp());
+            amount.emplace_back(event.amount());
+            pending.emplace_back(event.pendingamount());
+            type.emplace_back(static_cast<std::int32_t>(event.type()));
+            account.emplace_back(accounts.Add(event.id()));
+            workflow.emplace_back(workflows.Add(event.workflow()));
+            contact.emplace_back(contacts.Add(event.contact()));
+            live.emplace_back(1);
+            memoHeap.append(event.memo());
+            memoOffsets.emplace_back(memoHeap.size());
+        });
+
+    if (false == read) { return false; }
+
+    const std::vector<std::string> columns{
+        bytes(time),
+        bytes(amount),
+        bytes(pending),
+        bytes(type),
+        bytes(account),
+        bytes(workflow),
+        bytes(contact),
+        bytes(live),
+        bytes(memoOffsets),
+        memoHeap,
+        accounts.Offsets(),
+        accounts.Heap(),
+        workflows.Offsets(),
+        workflows.Heap(),
+        contacts.Offsets(),
+        contacts.Heap(),
+    };
+    std::string header(magic_, sizeof(magic_));
+    append(header, std::uint32_t{ACTIVITY_INDEX_VERSION});
+    append(header, static_cast<std::uint32_t>(Columns));
+    append(header, static_cast<std::uint64_t>(time.size()));
+    append(header, source);
+    std::uint64_t offset{header_size_};
+
+    // Every column starts on an eight byte boundary so it can be read in place
+    for (const auto& column : columns) {
+        append(header, offset);
+        append(header, static_cast<std::uint64_t>(column.size()));
+        offset += (column.size() + 7) & ~std::uint64_t{7};
+    }
+
+    const auto temporary = index + ".tmp";
+
+    {
+        std::ofstream file(
+            temporary, std::ios::out | std::ios::binary | std::ios::trunc);
+        file << header;
+
+        for (const auto& column : columns) {
+            file << column;
+            file << std::string((8 - (column.size() % 8)) % 8, '\0');
+        }
+
+        if (false == file.good()) {
+            LogOutput(__FUNCTION__)(": Unable to write ")(temporary).Flush();
+
+            return false;
+        }
+    }
+
+    boost::system::error_code ec{};
+    fs::rename(temporary, index, ec);
+
+    return false == bool(ec);
+}
+
+int ActivityIndex::Query(const std::vector<std::string>& args)
+{
+    std::string store{};
+    Filter filter{};
+    std::string group{};
+    std::size_t limit{std::numeric_limits<std::size_t>::max()};
+    bool countOnly{false};
+    bool sum{false};
+
+    po::options_description options("query");
+    options.add_options()("file", po::value<std::string>(&store), "<path>")(
+        "account", po::value<std::string>(&filter.account_), "<account id>")(
+        "contact", po::value<std::string>(&filter.contact_), "<contact id>")(
+        "workflow", po::value<std::string>(&filter.workflow_), "<workflow id>")(
+        "memo", po::value<std::string>(&filter.memo_), "<substring>")(
+        "type", po::value<int>(&filter.type_), "<account event type>")(
+        "from", po::value<std::int64_t>(&filter.from_), "<unix time>")(
+        "to", po::value<std::int64_t>(&filter.to_), "<unix time>")(
+        "group",
+        po::value<std::string>(&group),
+        "account|contact|type|workflow: totals per value")(
+        "limit", po::value<std::size_t>(&limit), "<maximum rows>")(
+        "count", po::bool_switch(&countOnly), "only print the match count")(
+        "sum", po::bool_switch(&sum), "only print count and amount totals");
+    po::positional_options_description positional{};
+    positional.add("file", 1);
+
+    try {
+        po::variables_map variables{};
+        po::store(
+            po::command_line_parser(args)
+                .options(options)
+                .positional(positional)
+                .run(),
+            variables);
+        po::notify(variables);
+    } catch (const po::error& e) {
+        std::cerr << "ERROR: " << e.what() << "\n\n" << options << std::endl;
+
+        return 1;
+    }
+
+    if (store.empty()) {
+        std::cerr << options << std::endl;
+
+        return 1;
+    }
+
+    const auto path = store + ".col";
+
+    if (false == Build(store, path)) {
+        std::cerr << "Unable to index " << store << std::endl;
+
+        return 1;
+    }
+
+    const ActivityIndex index(path);
+
+    if (false == index.good()) {
+        std::cerr << path << " is not an activity index" << std::endl;
+
+        return 1;
+    }
+
+    if (countOnly || sum) {
+        const auto totals = index.Scan(filter);
+        std::cout << totals.count_;
+
+        if (sum) {
+            std::cout << " " << totals.amount_ << " " << totals.pending_;
+        }
+
+        std::cout << std::endl;
+
+        return 0;
+    }
+
+    if (false == group.empty()) {
+        std::map<std::string, Totals> groups{};
+        const auto totals = index.Scan(filter, [&](const Row& row) {
+            std::string key{};
+
+            if ("account" == group) {
+                key = row.account_;
+            } else if ("contact" == group) {
+                key = row.contact_;
+            } else if ("workflow" == group) {
+                key = row.workflow_;
+            } else {
+                key = std::to_string(row.type_);
+            }
+
+            auto& item = groups[key];
+            ++item.count_;
+            item.amount_ += row.amount_;
+            item.pending_ += row.pending_;
+
+            return true;
+        });
+
+        for (const auto& [key, item] : groups) {
+            std::cout << key << "\t" << item.count_ << "\t" << item.amount_
+                      << "\t" << item.pending_ << "\n";
+        }
+
+        std::cout << "total\t" << totals.count_ << "\t" << totals.amount_
+                  << "\t" << totals.pending_ << std::endl;
+
+        return 0;
+    }
+
+    std::string out{};
+    out.reserve(1 << 20);
+    std::size_t printed{0};
+    index.Scan(filter, [&](const Row& row) {
+        if (printed++ >= limit) { return false; }
+
+        out.append(std::to_string(row.time_));
+        out.push_back('\t');
+        out.append(row.account_);
+        out.push_back('\t');
+        out.append(std::to_string(row.type_));
+        out.push_back('\t');
+        out.append(std::to_string(row.amount_));
+        out.push_back('\t');
+        out.append(std::to_string(row.pending_));
+        out.push_back('\t');
+        out.append(row.workflow_);
+        out.push_back('\t');
+        out.append(row.contact_);
+        out.push_back('\t');
+        out.append(row.memo_);
+        out.push_back('\n');
+
+        if (out.size() > (1 << 20)) {
+            std::cout << out;
+            out.clear();
+        }
+
+        return true;
+    });
+    std::cout << out << std::flush;
+
+    return 0;
+}
+
+ActivityIndex::Totals ActivityIndex::Scan(
+    const Filter& filter,
+    const Visitor& visitor) const
+{
+    Totals output{};
+
+    if (false == good_) { return output; }
+
+    // Identifier filters compare dictionary indices. A value which is not in
+    // the dictionary can not match anything.
+    const auto lookup = [](const Dictionary& dictionary,
+                           const std::string& value,
+                           std::uint32_t& index) {
+        if (value.empty()) { return true; }
+
+        index = static_cast<std::uint32_t>(dictionary.find(value));
+
+        return index < dictionary.size_;
+    };
+    std::uint32_t account{0}, workflow{0}, contact{0};
+
+    if ((false == lookup(accounts_, filter.account_, account)) ||
+        (false == lookup(workflows_, filter.workflow_, workflow)) ||
+        (false == lookup(contacts_, filter.contact_, contact))) {
+        return output;
+    }
+
+    const auto timeFilter =
+        (std::numeric_limits<std::int64_t>::min() != filter.from_) ||
+        (std::numeric_limits<std::int64_t>::max() != filter.to_);
+    std::uint8_t selected[ACTIVITY_INDEX_BLOCK];
+
+    for (std::size_t start{0}; start < rows_; start += ACTIVITY_INDEX_BLOCK) {
+        const auto count =
+            std::min<std::size_t>(ACTIVITY_INDEX_BLOCK, rows_ - start);
+        const auto* live = live_ + start;
+
+        for (std::size_t i{0}; i < count; ++i) { selected[i] = live[i]; }
+
+        if (timeFilter) {
+            const auto* time = time_ + start;
+
+            for (std::size_t i{0}; i < count; ++i) {
+                selected[i] &= static_cast<std::uint8_t>(
+                    (time[i] >= filter.from_) & (time[i] <= filter.to_));
+            }
+        }
+
+        if (-1 != filter.type_) {
+            const auto* type = type_ + start;
+
+            for (std::size_t i{0}; i < count; ++i) {
+                selected[i] &=
+                    static_cast<std::uint8_t>(type[i] == filter.type_);
+            }
+        }
+
+        const auto match = [&](const std::uint32_t* column,
+                               const std::uint32_t value) {
+            const auto* data = column + start;
+
+            for (std::size_t i{0}; i < count; ++i) {
+                selected[i] &= static_cast<std::uint8_t>(data[i] == value);
+            }
+        };
+
+        if (false == filter.account_.empty()) { match(account_, account); }
+
+        if (false == filter.workflow_.empty()) { match(workflow_, workflow); }
+
+        if (false == filter.contact_.empty()) { match(contact_, contact); }
+
+        if (false == filter.memo_.empty()) {
+            for (std::size_t i{0}; i < count; ++i) {
+                if (0 == selected[i]) { continue; }
+
+                selected[i] = static_cast<std::uint8_t>(
+                    std::string_view::npos !=
+                    memo_.at(start + i).find(filter.memo_));
+            }
+        }
+
+        const auto* amount = amount_ + start;
+        const auto* pending = pending_ + start;
+
+        for (std::size_t i{0}; i < count; ++i) {
+            output.count_ += selected[i];
+            output.amount_ += amount[i] * selected[i];
+            output.pending_ += pending[i] * selected[i];
+        }
+
+        if (false == bool(visitor)) { continue; }
+
+        for (std::size_t i{0}; i < count; ++i) {
+            if (0 == selected[i]) { continue; }
+
+            const auto row = start + i;
+            Row item{};
+            item.time_ = time_[row];
+            item.amount_ = amount_[row];
+            item.pending_ = pending_[row];
+            item.type_ = type_[row];
+            item.account_ = accounts_.at(account_[row]);
+            item.workflow_ = workflows_.at(workflow_[row]);
+            item.contact_ = contacts_.at(contact_[row]);
+            item.memo_ = memo_.at(row);
+
+            if (false == visitor(item)) { return output; }
+        }
+    }
+
+    return output;
+}
+
+ActivityIndex::~ActivityIndex() = default;
+}  // namespace opentxs::otctl
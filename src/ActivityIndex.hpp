@@ -0,0 +1,108 @@
+// Copyright (c) 2019 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace opentxs::otctl
+{
+class MappedFile;
+
+// Column oriented, memory mapped copy of an ActivityStore
+//
+// Each event field is stored as a contiguous array so that filters and sums
+// run as tight loops over a block of rows at a time. Strings which repeat
+// (accounts, workflows, contacts) are replaced by dictionary indices. Only the
+// latest version of every event is live. The index records the size of the
+// store it was built from and is rebuilt when the store has grown, or when it
+// fails validation.
+class ActivityIndex
+{
+public:
+    struct Filter {
+        std::string account_{};
+        std::string contact_{};
+        std::string workflow_{};
+        std::string memo_{};
+        int type_{-1};
+        std::int64_t from_{std::numeric_limits<std::int64_t>::min()};
+        std::int64_t to_{std::numeric_limits<std::int64_t>::max()};
+    };
+
+    struct Row {
+        std::int64_t time_{0};
+        std::int64_t amount_{0};
+        std::int64_t pending_{0};
+        int type_{0};
+        std::string_view account_{};
+        std::string_view workflow_{};
+        std::string_view contact_{};
+        std::string_view memo_{};
+    };
+
+    struct Totals {
+        std::uint64_t count_{0};
+        std::int64_t amount_{0};
+        std::int64_t pending_{0};
+    };
+
+    // Return false to stop the scan
+    using Visitor = std::function<bool(const Row&)>;
+
+    // Writes the index for a store unless an up to date one already exists
+    static bool Build(const std::string& store, const std::string& index);
+    static int Query(const std::vector<std::string>& args);
+
+    bool good() const { return good_; }
+    Totals Scan(const Filter& filter, const Visitor& visitor = {}) const;
+    std::size_t size() const { return rows_; }
+
+    ActivityIndex(const std::string& path);
+
+    ~ActivityIndex();
+
+private:
+    struct Dictionary {
+        const std::uint64_t* offsets_{nullptr};
+        const char* heap_{nullptr};
+        std::size_t size_{0};
+
+        std::string_view at(const std::size_t index) const;
+        // Returns size_ if the value is not present
+        std::size_t find(const std::string& value) const;
+    };
+
+    std::unique_ptr<MappedFile> file_;
+    bool good_;
+    std::size_t rows_;
+    // Size of the store the index was built from
+    std::uint64_t source_;
+    const std::int64_t* time_;
+    const std::int64_t* amount_;
+    const std::int64_t* pending_;
+    const std::int32_t* type_;
+    const std::uint32_t* account_;
+    const std::uint32_t* workflow_;
+    const std::uint32_t* contact_;
+    const std::uint8_t* live_;
+    Dictionary memo_;
+    Dictionary accounts_;
+    Dictionary workflows_;
+    Dictionary contacts_;
+
+    ActivityIndex() = delete;
+    ActivityIndex(const ActivityIndex&) = delete;
+    ActivityIndex(ActivityIndex&&) = delete;
+    ActivityIndex& operator=(const ActivityIndex&) = delete;
+    ActivityIndex& operator=(ActivityIndex&&) = delete;
+};
+}  // namespace opentxs::otctl
@@ -0,0 +1,199 @@
+// Copyright (c) 2019 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "ActivityStore.hpp"
+
+#include "Checksum.hpp"
+#include "MappedFile.hpp"
+
+#include <boost/filesystem.hpp>
+
+#include <cstring>
+
+#define ACTIVITY_STORE_VERSION 1
+
+namespace fs = boost::filesystem;
+
+namespace
+{
+const char magic_[] = {'O', 'T', 'C', 'T', 'L', 'A', 'C', 'T'};
+constexpr std::size_t header_size_{sizeof(magic_) + sizeof(std::uint32_t)};
+// crc, event size
+constexpr std::size_t record_fixed_{
+    sizeof(std::uint32_t) + sizeof(std::uint32_t)};
+
+template <typename T>
+void append(std::string& out, const T value)
+{
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+T extract(const std::uint8_t* in)
+{
+    T output{};
+    std::memcpy(&output, in, sizeof(output));
+
+    return output;
+}
+
+// Length of the intact prefix of the file, or zero if it is not a store
+std::size_t scan(
+    const opentxs::otctl::MappedFile& file,
+    const std::function<void(const char*, std::size_t)>& record)
+{
+    if ((false == file.good()) || (header_size_ > file.size()) ||
+        (0 != std::memcmp(file.data(), magic_, sizeof(magic_)))) {
+        return 0;
+    }
+
+    auto position = header_size_;
+
+    while (position + record_fixed_ <= file.size()) {
+        const auto* data = file.data() + position;
+        const auto crc = extract<std::uint32_t>(data);
+        const auto size = std::size_t{extract<std::uint32_t>(data + 4)};
+
+        if (size > file.size() - position - record_fixed_) { break; }
+
+        const auto* event =
+            reinterpret_cast<const char*>(data) + record_fixed_;
+
+        if (crc != opentxs::otctl::crc32(event, size)) { break; }
+
+        record(event, size);
+        position += record_fixed_ + size;
+    }
+
+    return position;
+}
+}  // namespace
+
+namespace opentxs::otctl
+{
+ActivityStore::ActivityStore(const std::string& path)
+    : lock_()
+    , accounts_()
+    , file_()
+{
+    boost::system::error_code ec{};
+
+    if ((false == fs::exists(path, ec)) || (0 == fs::file_size(path, ec))) {
+        std::ofstream file(path, std::ios::out | std::ios::binary);
+        std::string header(magic_, sizeof(magic_));
+        append(header, std::uint32_t{ACTIVITY_STORE_VERSION});
+        file << header;
+    } else {
+        std::size_t valid{0};
+        std::size_t size{0};
+
+        {
+            const MappedFile file(path);
+            size = file.size();
+            valid = scan(file, [&](const char* data, std::size_t bytes) {
+                proto::AccountEvent event{};
+
+                if (event.ParseFromArray(data, static_cast<int>(bytes))) {
+                    accounts_[event.id()][Key(event)] =
+                        std::hash<std::string>{}(std::string(data, bytes));
+                }
+            });
+        }
+
+        if (0 == valid) {
+            LogOutput(__FUNCTION__)(": ")(path)(" is not an activity store")
+                .Flush();
+
+            return;
+        }
+
+        if (valid != size) {
+            LogOutput(__FUNCTION__)(": Discarding ")(size - valid)(
+                " corrupt bytes from ")(path)
+                .Flush();
+            // Later appends must not land behind an unreadable record
+            fs::resize_file(path, valid, ec);
+        }
+    }
+
+    file_.open(path, std::ios::out | std::ios::binary | std::ios::app);
+
+    if (false == file_.good()) {
+        LogOutput(__FUNCTION__)(": Unable to open activity store ")(path)
+            .Flush();
+    }
+}
+
+std::size_t ActivityStore::Count(const std::string& account) const
+{
+    Lock lock(lock_);
+    const auto it = accounts_.find(account);
+
+    return (accounts_.end() == it) ? 0 : it->second.size();
+}
+
+// Events from before UUIDs were introduced fall back to their workflow,
+// type and time
+std::string ActivityStore::Key(const proto::AccountEvent& event)
+{
+    if (false == event.uuid().empty()) { return event.uuid(); }
+
+    return event.workflow() + ":" + std::to_string(event.type()) + ":" +
+           std::to_string(event.timestamp());
+}
+
+bool ActivityStore::Read(const std::string& path, const Visitor& visitor)
+{
+    const MappedFile file(path);
+    const auto valid =
+        scan(file, [&](const char* data, std::size_t bytes) {
+            proto::AccountEvent event{};
+
+            if (event.ParseFromArray(data, static_cast<int>(bytes))) {
+                visitor(event);
+            }
+        });
+
+    if (0 == valid) {
+        LogOutput(__FUNCTION__)(": ")(path)(" is not an activity store")
+            .Flush();
+
+        return false;
+    }
+
+    return true;
+}
+
+bool ActivityStore::store(const std::string& bytes)
+{
+    if (false == file_.good()) { return false; }
+
+    std::string record{};
+    record.reserve(record_fixed_ + bytes.size());
+    append(record, crc32(bytes.data(), bytes.size()));
+    append(record, static_cast<std::uint32_t>(bytes.size()));
+    record.append(bytes);
+    file_ << record;
+
+    return true;
+}
+
+bool ActivityStore::Update(const proto::AccountEvent& event)
+{
+    const auto bytes = event.SerializeAsString();
+    const auto digest = std::hash<std::string>{}(bytes);
+    Lock lock(lock_);
+    auto& existing = accounts_[event.id()][Key(event)];
+
+    if (digest == existing) { return false; }
+
+    existing = digest;
+    store(bytes);
+
+    return true;
+}
+
+ActivityStore::~ActivityStore() { file_.flush(); }
+}  // namespace opentxs::otctl
@@ -0,0 +1,60 @@
+// Copyright (c) 2019 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <opentxs/opentxs.hpp>
+
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace opentxs::otctl
+{
+// Local append-only history of account events
+//
+// Every version of an event ever seen is appended to the backing file, keyed
+// by account and event UUID, so later polls can tell which events are new or
+// changed. Only a digest of the latest version of each event is kept in
+// memory.
+class ActivityStore
+{
+public:
+    using Visitor = std::function<void(const proto::AccountEvent&)>;
+
+    // Identifies an event within its account across versions
+    static std::string Key(const proto::AccountEvent& event);
+    // Calls visitor with every record in the file, oldest first
+    static bool Read(const std::string& path, const Visitor& visitor);
+
+    std::size_t Count(const std::string& account) const;
+
+    // Returns true if the event was not known or differs from the stored copy
+    bool Update(const proto::AccountEvent& event);
+
+    ActivityStore(const std::string& path);
+
+    ~ActivityStore();
+
+private:
+    using Events = std::unordered_map<std::string, std::size_t>;
+
+    mutable std::mutex lock_;
+    std::map<std::string, Events> accounts_;
+    std::ofstream file_;
+
+    bool store(const std::string& bytes);
+
+    ActivityStore() = delete;
+    ActivityStore(const ActivityStore&) = delete;
+    ActivityStore(ActivityStore&&) = delete;
+    ActivityStore& operator=(const ActivityStore&) = delete;
+    ActivityStore& operator=(ActivityStore&&) = delete;
+};
+}  // namespace opentxs::otctl
@@ -0,0 +1,315 @@
+// Copyright (c) 2019 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "BenchReport.hpp"
+
+#include <opentxs/opentxs.hpp>
+
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+#if __has_include("json/json.h")
+#include <json/json.h>
+#elif __has_include("jsoncpp/json/json.h")
+#include <jsoncpp/json/json.h>
+#endif
+
+#define BENCH_REPORT_VERSION 1
+// Two sided p-value below which a difference counts as real
+#define BENCH_SIGNIFICANCE 0.05
+// Smallest relative change worth reporting as a regression
+#define BENCH_THRESHOLD 0.05
+
+namespace
+{
+struct Metric {
+    const char* name_;
+    double opentxs::otctl::BenchReport::Trial::*value_;
+    // Throughput regresses when it falls, latency when it rises
+    bool higher_is_better_;
+};
+
+const Metric metrics_[] = {
+    {"throughput", &opentxs::otctl::BenchReport::Trial::throughput_, true},
+    {"p50", &opentxs::otctl::BenchReport::Trial::p50_, false},
+    {"p90", &opentxs::otctl::BenchReport::Trial::p90_, false},
+    {"p99", &opentxs::otctl::BenchReport::Trial::p99_, false},
+    {"p99.9", &opentxs::otctl::BenchReport::Trial::p999_, false},
+};
+
+// Continued fraction for the regularized incomplete beta function
+double beta_fraction(const double a, const double b, const double x)
+{
+    const double tiny{1e-300};
+    const auto qab = a + b;
+    const auto qap = a + 1.0;
+    const auto qam = a - 1.0;
+    auto c = 1.0;
+    auto d = 1.0 - qab * x / qap;
+
+    if (std::fabs(d) < tiny) { d = tiny; }
+
+    d = 1.0 / d;
+    auto output = d;
+
+    for (int m{1}; m <= 200; ++m) {
+        const auto m2 = 2.0 * m;
+        auto aa = m * (b - m) * x / ((qam + m2) * (a + m2));
+        d = 1.0 + aa * d;
+
+        if (std::fabs(d) < tiny) { d = tiny; }
+
+        c = 1.0 + aa / c;
+
+        if (std::fabs(c) < tiny) { c = tiny; }
+
+        d = 1.0 / d;
+        output *= d * c;
+        aa = -(a + m) * (qab + m) * x / ((a + m2) * (qap + m2));
+        d = 1.0 + aa * d;
+
+        if (std::fabs(d) < tiny) { d = tiny; }
+
+        c = 1.0 + aa / c;
+
+        if (std::fabs(c) < tiny) { c = tiny; }
+
+        d = 1.0 / d;
+        const auto delta = d * c;
+        output *= delta;
+
+        if (std::fabs(delta - 1.0) < 1e-12) { break; }
+    }
+
+    return output;
+}
+
+double incomplete_beta(const double a, const double b, const double x)
+{
+    if (0.0 >= x) { return 0.0; }
+
+    if (1.0 <= x) { return 1.0; }
+
+    const auto front = std::exp(
+        std::lgamma(a + b) - std::lgamma(a) - std::lgamma(b) +
+        a * std::log(x) + b * std::log(1.0 - x));
+
+    if (x < (a + 1.0) / (a + b + 2.0)) {
+        return front * beta_fraction(a, b, x) / a;
+    }
+
+    return 1.0 - front * beta_fraction(b, a, 1.0 - x) / b;
+}
+
+void moments(const std::vector<double>& in, double& mean, double& variance)
+{
+    mean = 0;
+    variance = 0;
+
+    for (const auto value : in) { mean += value; }
+
+    mean /= static_cast<double>(in.size());
+
+    for (const auto value : in) { variance += (value - mean) * (value - mean); }
+
+    variance /= static_cast<double>(in.size() - 1);
+}
+
+// Two sided p-value of Welch's t-test
+double welch(const std::vector<double>& a, const std::vector<double>& b)
+{
+    double meanA{}, varA{}, meanB{}, varB{};
+    moments(a, meanA, varA);
+    moments(b, meanB, varB);
+    const auto sa = varA / static_cast<double>(a.size());
+    const auto sb = varB / static_cast<double>(b.size());
+    const auto error = sa + sb;
+
+    if (0.0 >= error) { return (meanA == meanB) ? 1.0 : 0.0; }
+
+    const auto t = (meanA - meanB) / std::sqrt(error);
+    const auto df =
+        (error * error) / ((sa * sa) / static_cast<double>(a.size() - 1) +
+                           (sb * sb) / static_cast<double>(b.size() - 1));
+
+    return incomplete_beta(df / 2.0, 0.5, df / (df + t * t));
+}
+}  // namespace
+
+namespace opentxs::otctl
+{
+bool BenchReport::Compare(
+    const std::vector<Trial>& baseline,
+    const std::vector<Trial>& current,
+    std::string& out)
+{
+    std::stringstream output{};
+
+    if ((2 > baseline.size()) || (2 > current.size())) {
+        output << "At least two trials are required on each side, have "
+               << baseline.size() << " baseline and " << current.size()
+               << " current\n";
+        out = output.str();
+
+        return false;
+    }
+
+    bool regressed{false};
+    output << std::left << std::setw(12) << "metric" << std::right
+           << std::setw(14) << "baseline" << std::setw(14) << "current"
+           << std::setw(10) << "change" << std::setw(10) << "p-value"
+           << "\n";
+
+    for (const auto& metric : metrics_) {
+        std::vector<double> before{}, after{};
+
+        for (const auto& trial : baseline) {
+            before.emplace_back(trial.*metric.value_);
+        }
+
+        for (const auto& trial : current) {
+            after.emplace_back(trial.*metric.value_);
+        }
+
+        double meanBefore{}, meanAfter{}, variance{};
+        moments(before, meanBefore, variance);
+        moments(after, meanAfter, variance);
+        const auto change = (0.0 == meanBefore)
+                                ? 0.0
+                                : (meanAfter - meanBefore) / meanBefore;
+        const auto p = welch(before, after);
+        const auto worse = metric.higher_is_better_ ? (change < 0.0)
+                                                    : (change > 0.0);
+        const auto significant = (BENCH_SIGNIFICANCE > p) &&
+                                 (BENCH_THRESHOLD < std::fabs(change));
+        output << std::left << std::setw(12) << metric.name_ << std::right
+               << std::fixed << std::setprecision(1) << std::setw(14)
+               << meanBefore << std::setw(14) << meanAfter << std::setw(9)
+               << std::showpos << (100.0 * change) << std::noshowpos << "%"
+               << std::setprecision(4) << std::setw(10) << p;
+
+        if (significant) {
+            output << (worse ? "  REGRESSION" : "  improved");
+            regressed |= worse;
+        }
+
+        output << "\n";
+    }
+
+    out = output.str();
+
+    return regressed;
+}
+
+bool BenchReport::Load(
+    const std::string& path,
+    const std::string& name,
+    std::vector<Trial>& out)
+{
+    std::ifstream file(path);
+    Json::Value root{};
+
+    try {
+        file >> root;
+    } catch (const std::exception& e) {
+        LogOutput(__FUNCTION__)(": Unable to read ")(path)(": ")(e.what())
+            .Flush();
+
+        return false;
+    }
+
+    const auto& entry = root["commands"][name];
+
+    if (false == entry.isObject()) {
+        LogOutput(__FUNCTION__)(": ")(path)(" has no results for ")(name)
+            .Flush();
+
+        return false;
+    }
+
+    for (const auto& item : entry["trials"]) {
+        Trial trial{};
+        trial.sent_ = item["sent"].asUInt64();
+        trial.received_ = item["received"].asUInt64();
+        trial.throughput_ = item["throughput"].asDouble();
+        trial.p50_ = item["p50"].asDouble();
+        trial.p90_ = item["p90"].asDouble();
+        trial.p99_ = item["p99"].asDouble();
+        trial.p999_ = item["p99.9"].asDouble();
+        out.emplace_back(trial);
+    }
+
+    return true;
+}
+
+bool BenchReport::Save(
+    const std::string& path,
+    const std::string& name,
+    const std::string& command,
+    const Environment& environment,
+    const std::vector<Trial>& trials)
+{
+    Json::Value root{Json::objectValue};
+
+    {
+        std::ifstream file(path);
+
+        if (file.good()) {
+            try {
+                file >> root;
+            } catch (...) {
+                root = Json::Value{};
+            }
+
+            // Baselines of other commands must not be discarded
+            if (false == root.isObject()) {
+                LogOutput(__FUNCTION__)(": ")(path)(
+                    " is not a bench result file, refusing to overwrite it")
+                    .Flush();
+
+                return false;
+            }
+        }
+    }
+
+    root["version"] = BENCH_REPORT_VERSION;
+    auto& entry = root["commands"][name];
+    entry = Json::Value{Json::objectValue};
+    entry["command"] = command;
+
+    for (const auto& [key, value] : environment) {
+        entry["environment"][key] = value;
+    }
+
+    entry["trials"] = Json::Value{Json::arrayValue};
+
+    for (const auto& trial : trials) {
+        Json::Value item{Json::objectValue};
+        item["sent"] = Json::UInt64{trial.sent_};
+        item["received"] = Json::UInt64{trial.received_};
+        item["throughput"] = trial.throughput_;
+        item["p50"] = trial.p50_;
+        item["p90"] = trial.p90_;
+        item["p99"] = trial.p99_;
+        item["p99.9"] = trial.p999_;
+        entry["trials"].append(item);
+    }
+
+    std::ofstream file(path, std::ios::out | std::ios::trunc);
+    file << root;
+
+    if (false == file.good()) {
+        LogOutput(__FUNCTION__)(": Unable to write ")(path).Flush();
+
+        return false;
+    }
+
+    return true;
+}
+}  // namespace opentxs::otctl
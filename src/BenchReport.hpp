@@ -0,0 +1,59 @@
+// Copyright (c) 2019 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace opentxs::otctl
+{
+// Persistent bench results and comparison against a stored baseline
+//
+// A result file is a JSON object holding, per command name, the command line,
+// the environment it ran in and the outcome of every trial. Comparisons use
+// Welch's t-test across trials, so both runs need at least two trials.
+class BenchReport
+{
+public:
+    struct Trial {
+        std::uint64_t sent_{0};
+        std::uint64_t received_{0};
+        // Replies per second
+        double throughput_{0};
+        // Latency percentiles in microseconds
+        double p50_{0};
+        double p90_{0};
+        double p99_{0};
+        double p999_{0};
+    };
+
+    using Environment = std::map<std::string, std::string>;
+
+    // Formats a comparison table. Returns true if any metric got
+    // significantly worse.
+    static bool Compare(
+        const std::vector<Trial>& baseline,
+        const std::vector<Trial>& current,
+        std::string& out);
+    static bool Load(
+        const std::string& path,
+        const std::string& name,
+        std::vector<Trial>& out);
+    // Replaces the entry for this command, keeping any others in the file.
+    // An existing file which can not be parsed is left untouched.
+    static bool Save(
+        const std::string& path,
+        const std::string& name,
+        const std::string& command,
+        const Environment& environment,
+        const std::vector<Trial>& trials);
+
+private:
+    BenchReport() = delete;
+};
+}  // namespace opentxs::otctl
@@ -4,12 +4,26 @@
 // file, You can obtain one at http://mozilla.org/MPL/2.0/.
 
 #include <chrono>
+#include <condition_variable>
 #include <ctime>
+#include <deque>
 #include <iostream>
 #include <fstream>
+#include <future>
+#include <iomanip>
+#include <memory>
+#include <random>
+#include <set>
 #include <string>
+#include <thread>
+#include <tuple>
 
 #include "CLI.hpp"
+#include "Checksum.hpp"
+#include "PaymentJournal.hpp"
+#include "Snapshot.hpp"
+#include "Window.hpp"
+#include "WorkerPool.hpp"
 #include "util.h"
 
 #include <boost/algorithm/string.hpp>
@@ -34,15 +48,30 @@ namespace zmq = opentxs::network::zeromq;
 #define ACCEPTPENDINGPAYMENT_VERSION 1
 #define ADD_CONTACT_VERSION 1
 #define API_ARG_VERSION 1
+#define BATCH_SIZE 100
+#define BENCH_COUNT 10000
+#define BENCH_TRIALS 5
+#define BENCH_WINDOW 64
 #define CREATE_NYM_VERSION 1
 #define CREATE_UNITDEFINITION_VERSION 1
+#define FANOUT_WINDOW 32
 #define GETWORKFLOW_VERSION 1
 #define HDSEED_VERSION 1
+#define LIST_PAGE_SIZE 1000
 #define MOVEFUNDS_VERSION 1
+#define PENDING_CONTEXTS 4096
+#define RECONCILE_SUSPECTS 5
+#define RETRY_ATTEMPTS 5
+#define RETRY_BASE_DELAY_MS 50
+#define RETRY_MAX_DELAY_MS 5000
 #define RPC_COMMAND_VERSION 2
+#define RPC_STATUS_VERSION 1
+#define RPC_TIMEOUT_SECONDS 60
 #define SENDPAYMENT_VERSION 1
+#define WORKFLOW_HIGHEST_DWELL 315360000
 
 const std::string HISTORY = {"history"};
+const std::string LOGS = {"logs"};
 const std::string WRITE_HISTORY = {"write_history"};
 const std::string READ_HISTORY = {"read_history"};
 
@@ -64,6 +93,7 @@ const std::map<std::string, proto::RPCCommandType> CLI::commands_{
     {"getpendingpayments", proto::RPCCOMMAND_GETPENDINGPAYMENTS},
     {"getseed", proto::RPCCOMMAND_GETHDSEED},
     {"getserver", proto::RPCCOMMAND_GETSERVERCONTRACT},
+    {"getunitdefinition", proto::RPCCOMMAND_GETUNITDEFINITION},
     {"getworkflow", proto::RPCCOMMAND_GETWORKFLOW},
     {"importseed", proto::RPCCOMMAND_IMPORTHDSEED},
     {"importserver", proto::RPCCOMMAND_IMPORTSERVERCONTRACT},
@@ -82,6 +112,17 @@ const std::map<std::string, proto::RPCCommandType> CLI::commands_{
     {"transfer", proto::RPCCOMMAND_SENDPAYMENT},
     {"gettransactiondata", proto::RPCCOMMAND_GETTRANSACTIONDATA},
 };
+const std::map<std::string, CLI::Processor> CLI::composites_{
+    {"balances", &CLI::balances},
+    {"bench", &CLI::bench},
+    {"fleet", &CLI::fleet},
+    {"payments", &CLI::payments},
+    {"provision", &CLI::provision},
+    {"reconcile", &CLI::reconcile},
+    {"replay", &CLI::replay},
+    {"snapshot", &CLI::snapshot},
+    {"workflowstats", &CLI::workflow_stats},
+};
 const std::map<proto::RPCPushType, CLI::PushHandler> CLI::push_handlers_{
     {proto::RPCPUSH_ACCOUNT, &CLI::account_event_push},
     {proto::RPCPUSH_TASK, &CLI::task_complete_push},
@@ -111,6 +152,8 @@ const std::map<proto::RPCCommandType, CLI::ResponseHandler>
         {proto::RPCCOMMAND_GETHDSEED, &CLI::get_seed_response},
         {proto::RPCCOMMAND_GETSERVERCONTRACT,
          &CLI::get_server_contract_response},
+        {proto::RPCCOMMAND_GETUNITDEFINITION,
+         &CLI::get_unit_definition_response},
         {proto::RPCCOMMAND_GETWORKFLOW, &CLI::get_workflow_response},
         {proto::RPCCOMMAND_IMPORTHDSEED, &CLI::import_seed_response},
         {proto::RPCCOMMAND_IMPORTSERVERCONTRACT,
@@ -149,6 +192,7 @@ const std::map<proto::RPCCommandType, CLI::Processor> CLI::processors_{
     {proto::RPCCOMMAND_GETPENDINGPAYMENTS, &CLI::get_pending_payments},
     {proto::RPCCOMMAND_GETHDSEED, &CLI::get_seed},
     {proto::RPCCOMMAND_GETSERVERCONTRACT, &CLI::get_server_contract},
+    {proto::RPCCOMMAND_GETUNITDEFINITION, &CLI::get_unit_definition},
     {proto::RPCCOMMAND_IMPORTSERVERCONTRACT, &CLI::import_server_contract},
     {proto::RPCCOMMAND_IMPORTHDSEED, &CLI::import_seed},
     {proto::RPCCOMMAND_ISSUEUNITDEFINITION, &CLI::issue_unit_definition},
@@ -235,11 +279,55 @@ CLI::CLI(const api::Context& ot, const po::variables_map& options)
     : options_(options)
     , endpoint_(get_socket_path(options_))
     , history_()
+    , cookies_()
+    , tracker_()
+    , log_correlator_()
+    , context_lock_()
+    , pages_()
+    , page_order_()
+    , batches_()
+    , batch_order_()
+    , capture_lock_()
+    , capture_(nullptr)
+    , capturing_()
+    , load_lock_()
+    , load_()
+    , recorder_(
+          (0 == options_.count("record"))
+              ? nullptr
+              : std::make_unique<TrafficRecorder>(
+                    options_["record"].as<std::string>()))
+    , exit_status_(0)
+    , tracer_(
+          (0 == options_.count("trace"))
+              ? nullptr
+              : std::make_unique<Tracer>(options_["trace"].as<std::string>()))
+    , retries_(
+          (0 == options_.count("retries"))
+              ? RETRY_ATTEMPTS
+              : options_["retries"].as<std::size_t>())
+    , scheduler_()
+    , cache_(
+          (0 == options_.count("cache"))
+              ? nullptr
+              : std::make_unique<ObjectCache>(
+                    options_["cache"].as<std::string>()))
+    , activity_(
+          (0 == options_.count("activity"))
+              ? nullptr
+              : std::make_unique<ActivityStore>(
+                    options_["activity"].as<std::string>()))
     , callback_(zmq::ListenCallback::Factory(
           std::bind(&CLI::callback, this, std::placeholders::_1)))
     , socket_(ot.ZMQ().DealerSocket(
           callback_,
           zmq::socket::Socket::Direction::Connect))
+    , fleet_()
+    , log_archive_(
+          (0 == options_.count("logfile"))
+              ? nullptr
+              : std::make_unique<LogArchive>(
+                    options_["logfile"].as<std::string>()))
     , log_callback_(zmq::ListenCallback::Factory(
           std::bind(&CLI::remote_log, this, std::placeholders::_1)))
     , log_subscriber_(ot.ZMQ().SubscribeSocket(log_callback_))
@@ -251,6 +339,37 @@ CLI::CLI(const api::Context& ot, const po::variables_map& options)
 
     OT_ASSERT(connected)
 
+    if (0 != options_.count("fleet")) {
+        const auto& path = options_["fleet"].as<std::string>();
+        std::vector<std::string> lines{};
+
+        if (false == read_items(path, lines)) {
+            LogOutput(__FUNCTION__)(": Unable to read ")(path).Flush();
+        }
+
+        // Each line is an endpoint optionally followed by its keyfile
+        for (const auto& line : lines) {
+            std::stringstream fields(line);
+            std::string endpoint{};
+            std::string keyfile{};
+            fields >> endpoint >> keyfile;
+            auto peer = ot.ZMQ().DealerSocket(
+                callback_, zmq::socket::Socket::Direction::Connect);
+            set_keys(
+                keyfile.empty() ? get_json(options_) : get_json(keyfile),
+                peer);
+
+            if (false == peer->Start(endpoint)) {
+                LogOutput(__FUNCTION__)(": Unable to connect to ")(endpoint)
+                    .Flush();
+
+                continue;
+            }
+
+            fleet_.emplace(endpoint, std::move(peer));
+        }
+    }
+
     if (options_.count("logendpoint") != 0) {
         connected =
             log_subscriber_->Start(options_["logendpoint"].as<std::string>());
@@ -263,6 +382,9 @@ void CLI::account_event_push(const proto::RPCPush& in, const int instance)
 {
     print_basic_info(in);
     const auto& event = in.accountevent();
+
+    if (activity_) { activity_->Update(event); }
+
     std::stringstream time{};
     time << std::time_t{event.timestamp()};
 
@@ -284,7 +406,9 @@ void CLI::accept_pending_payment(
 {
     int instance{-1};
     std::string destinationAccount{""};
-    std::string workflow{""};
+    std::vector<std::string> workflows{};
+    std::string file{""};
+    std::size_t batchSize{BATCH_SIZE};
 
     po::options_description options("Options");
     options.add_options()("instance", po::value<int>(&instance), "<number>");
@@ -293,7 +417,12 @@ void CLI::accept_pending_payment(
         po::value<std::string>(&destinationAccount),
         "<string>");
     options.add_options()(
-        "workflow", po::value<std::string>(&workflow), "<string>");
+        "workflow",
+        po::value<std::vector<std::string>>(&workflows)->multitoken(),
+        "<string>...");
+    options.add_options()("file", po::value<std::string>(&file), "<path>");
+    options.add_options()(
+        "batchsize", po::value<std::size_t>(&batchSize), "<number>");
     auto hasOptions = parse_command(in, options);
 
     if (!hasOptions) {
@@ -307,41 +436,82 @@ void CLI::accept_pending_payment(
         return;
     }
 
-    if (destinationAccount.empty()) {
+    if ((false == workflows.empty()) && destinationAccount.empty()) {
         LogOutput(__FUNCTION__)(": Missing destination account option").Flush();
 
         return;
     }
 
-    if (workflow.empty()) {
-        LogOutput(__FUNCTION__)(": Missing workflow option").Flush();
+    std::vector<std::pair<std::string, std::string>> payments{};
+
+    for (const auto& workflow : workflows) {
+        payments.emplace_back(destinationAccount, workflow);
+    }
+
+    // Each line of the file holds a destination account and a workflow ID
+    std::vector<std::string> lines{};
+
+    if ((false == file.empty()) && (false == read_items(file, lines))) {
+        LogOutput(__FUNCTION__)(": Unable to read ")(file).Flush();
 
         return;
     }
 
-    proto::RPCCommand out{};
-    out.set_version(RPC_COMMAND_VERSION);
-    out.set_cookie(Identifier::Random()->str());
-    out.set_type(proto::RPCCOMMAND_ACCEPTPENDINGPAYMENTS);
-    out.set_session(instance);
+    for (const auto& line : lines) {
+        std::vector<std::string> fields{};
+        boost::split(
+            fields, line, boost::is_any_of(", \t"), boost::token_compress_on);
 
-    auto& acceptpendingpayment = *out.add_acceptpendingpayment();
-    acceptpendingpayment.set_version(ACCEPTPENDINGPAYMENT_VERSION);
-    acceptpendingpayment.set_destinationaccount(destinationAccount);
-    acceptpendingpayment.set_workflow(workflow);
+        if (2 != fields.size()) {
+            LogOutput(__FUNCTION__)(": Invalid line: ")(line).Flush();
+
+            return;
+        }
 
-    const auto valid = proto::Validate(out, VERBOSE);
+        payments.emplace_back(fields.at(0), fields.at(1));
+    }
 
-    OT_ASSERT(valid)
+    if (payments.empty()) {
+        LogOutput(__FUNCTION__)(": Missing workflow option").Flush();
 
-    const auto sent = send_message(socket, out);
+        return;
+    }
 
-    OT_ASSERT(sent)
+    batchSize = std::max(batchSize, std::size_t{1});
+
+    for (std::size_t first{0}; first < payments.size(); first += batchSize) {
+        const auto last = std::min(payments.size(), first + batchSize);
+        std::vector<std::string> items{};
+        proto::RPCCommand out{};
+        out.set_version(RPC_COMMAND_VERSION);
+        out.set_cookie(cookies_.Next());
+        out.set_type(proto::RPCCOMMAND_ACCEPTPENDINGPAYMENTS);
+        out.set_session(instance);
+
+        for (auto i = first; i < last; ++i) {
+            const auto& [destination, workflow] = payments.at(i);
+            auto& acceptpendingpayment = *out.add_acceptpendingpayment();
+            acceptpendingpayment.set_version(ACCEPTPENDINGPAYMENT_VERSION);
+            acceptpendingpayment.set_destinationaccount(destination);
+            acceptpendingpayment.set_workflow(workflow);
+            items.emplace_back(workflow);
+        }
+
+        const auto valid = validate(out);
+
+        OT_ASSERT(valid)
+
+        set_batch(out.cookie(), std::move(items));
+        const auto sent = send_message(socket, out);
+
+        OT_ASSERT(sent)
+    }
 }
 
 void CLI::accept_pending_payment_response(const proto::RPCResponse& in)
 {
     print_basic_info(in);
+    print_items(in);
 
     for (const auto& taskid : in.identifier()) {
 
@@ -355,10 +525,10 @@ void CLI::add_client_session(
 {
     proto::RPCCommand out{};
     out.set_version(RPC_COMMAND_VERSION);
-    out.set_cookie(Identifier::Random()->str());
+    out.set_cookie(cookies_.Next());
     out.set_type(proto::RPCCOMMAND_ADDCLIENTSESSION);
     out.set_session(-1);
-    const auto valid = proto::Validate(out, VERBOSE);
+    const auto valid = validate(out);
 
     OT_ASSERT(valid)
 
@@ -401,7 +571,7 @@ void CLI::add_contact(const std::string& in, const zmq::socket::Dealer& socket)
 
     proto::RPCCommand out{};
     out.set_version(RPC_COMMAND_VERSION);
-    out.set_cookie(Identifier::Random()->str());
+    out.set_cookie(cookies_.Next());
     out.set_type(proto::RPCCOMMAND_ADDCONTACT);
     out.set_session(instance);
     auto& addcontact = *out.add_addcontact();
@@ -409,7 +579,7 @@ void CLI::add_contact(const std::string& in, const zmq::socket::Dealer& socket)
     addcontact.set_label(label);
     addcontact.set_paymentcode(paymentcode);
     addcontact.set_nymid(nymid);
-    const auto valid = proto::Validate(out, VERBOSE);
+    const auto valid = validate(out);
 
     OT_ASSERT(valid)
 
@@ -427,6 +597,18 @@ void CLI::add_contact_response(const proto::RPCResponse& in)
     }
 }
 
+void CLI::add_page_options(po::options_description& options, Page& page)
+{
+    options.add_options()(
+        "start", po::value<std::size_t>(&page.start_), "<number>");
+    options.add_options()(
+        "after", po::value<std::string>(&page.after_), "<string>");
+    options.add_options()(
+        "limit", po::value<std::size_t>(&page.limit_), "<number>");
+    options.add_options()(
+        "pagesize", po::value<std::size_t>(&page.size_), "<number>");
+}
+
 void CLI::add_server_session(
     const std::string& in,
     const zmq::socket::Dealer& socket)
@@ -443,7 +625,7 @@ void CLI::add_server_session(
 
     proto::RPCCommand out{};
     out.set_version(RPC_COMMAND_VERSION);
-    out.set_cookie(Identifier::Random()->str());
+    out.set_cookie(cookies_.Next());
     out.set_type(proto::RPCCOMMAND_ADDSERVERSESSION);
     out.set_session(-1);
 
@@ -472,7 +654,7 @@ void CLI::add_server_session(
         arg.add_value(onion);
     }
 
-    const auto valid = proto::Validate(out, VERBOSE);
+    const auto valid = validate(out);
 
     OT_ASSERT(valid)
 
@@ -487,6 +669,306 @@ void CLI::add_session_response(const proto::RPCResponse& in)
     LogOutput("   Session: ")(in.session()).Flush();
 }
 
+// Lists the accounts of a session then pipelines a balance request for each
+// one, keeping at most --window requests outstanding.
+void CLI::balances(const std::string& in, const zmq::socket::Dealer& socket)
+{
+    struct Row {
+        std::string id_{};
+        std::int64_t balance_{0};
+        std::int64_t pending_{0};
+        std::string status_{};
+    };
+    struct State {
+        std::mutex lock_{};
+        std::vector<Row> rows_{};
+    };
+
+    int instance{-1};
+    std::size_t window{FANOUT_WINDOW};
+    std::string sortBy{"id"};
+
+    po::options_description options("Options");
+    options.add_options()("instance", po::value<int>(&instance), "<number>");
+    options.add_options()(
+        "window", po::value<std::size_t>(&window), "<number>");
+    options.add_options()(
+        "sortby", po::value<std::string>(&sortBy), "id|balance");
+    auto hasOptions = parse_command(in, options);
+
+    if (!hasOptions) {
+        print_options_description(options);
+        return;
+    }
+
+    if (-1 == instance) {
+        LogOutput(__FUNCTION__)(": Missing instance option").Flush();
+
+        return;
+    }
+
+    proto::RPCResponse accounts{};
+
+    if (false ==
+        request(
+            socket,
+            new_command(proto::RPCCOMMAND_LISTACCOUNTS, instance),
+            accounts)) {
+        LogOutput(__FUNCTION__)(": No reply to LISTACCOUNTS").Flush();
+        exit_status_ = 1;
+
+        return;
+    }
+
+    // NONE is how an empty list is reported
+    if ((0 < accounts.status_size()) &&
+        (proto::RPCRESPONSE_SUCCESS != accounts.status(0).code()) &&
+        (proto::RPCRESPONSE_NONE != accounts.status(0).code())) {
+        LogOutput(__FUNCTION__)(": LISTACCOUNTS failed: ")(
+            get_status_name(accounts.status(0).code()))
+            .Flush();
+        exit_status_ = 1;
+
+        return;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const std::chrono::seconds timeout{RPC_TIMEOUT_SECONDS};
+    auto state = std::make_shared<State>();
+    auto slots = std::make_shared<Window>(window, true);
+
+    for (const auto& id : accounts.identifier()) {
+        if (false == slots->Acquire(timeout)) {
+            LogOutput(__FUNCTION__)(": Timed out waiting for replies").Flush();
+
+            return;
+        }
+
+        auto command =
+            new_command(proto::RPCCOMMAND_GETACCOUNTBALANCE, instance);
+        command.add_identifier(id);
+        const auto valid = validate(command);
+
+        OT_ASSERT(valid)
+
+        const auto sent = send_message(
+            socket, command, [state, slots, id](const auto& reply) {
+                Lock lock(state->lock_);
+
+                if (0 == reply.balance_size()) {
+                    const auto status =
+                        (0 < reply.status_size())
+                            ? get_status_name(reply.status(0).code())
+                            : std::string{"NONE"};
+                    state->rows_.push_back({id, 0, 0, status});
+                }
+
+                for (const auto& balance : reply.balance()) {
+                    state->rows_.push_back({balance.id(),
+                                            balance.balance(),
+                                            balance.pendingbalance(),
+                                            ""});
+                }
+
+                lock.unlock();
+                slots->Release();
+            },
+            {},
+            slots);
+
+        if (false == sent) { slots->Release(); }
+    }
+
+    if (false == slots->Wait(timeout)) {
+        LogOutput(__FUNCTION__)(": Timed out waiting for replies").Flush();
+
+        return;
+    }
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+    Lock lock(state->lock_);
+    auto& rows = state->rows_;
+
+    if ("balance" == sortBy) {
+        std::sort(
+            rows.begin(), rows.end(), [](const auto& lhs, const auto& rhs) {
+                return std::tie(rhs.balance_, lhs.id_) <
+                       std::tie(lhs.balance_, rhs.id_);
+            });
+    } else {
+        std::sort(
+            rows.begin(), rows.end(), [](const auto& lhs, const auto& rhs) {
+                return lhs.id_ < rhs.id_;
+            });
+    }
+
+    std::stringstream out{};
+    out << std::left << std::setw(48) << "Account ID" << std::right
+        << std::setw(20) << "Balance" << std::setw(20) << "Pending" << "\n";
+
+    for (const auto& row : rows) {
+        out << std::left << std::setw(48) << row.id_ << std::right;
+
+        if (row.status_.empty()) {
+            out << std::setw(20) << row.balance_ << std::setw(20)
+                << row.pending_ << "\n";
+        } else {
+            out << "  " << row.status_ << "\n";
+        }
+    }
+
+    out << rows.size() << " accounts in " << elapsed.count() << " ms";
+    LogOutput(out.str()).Flush();
+}
+
+// Usage: bench [--count N] [--window N] [--rate N] [--trials N]
+//              [--output <file>] [--compare <file>] -- <command> <options>
+//
+// With --rate commands are sent open loop at a fixed rate and the window
+// defaults to unlimited. --output stores the trials under the command name,
+// --compare tests them against the trials stored in a baseline file.
+void CLI::bench(const std::string& in, const zmq::socket::Dealer& socket)
+{
+    const auto separator = in.find(" -- ");
+
+    if (std::string::npos == separator) {
+        LogOutput(__FUNCTION__)(
+            ": Usage: bench [--count N] [--window N] [--rate N] [--trials N] "
+            "[--output <file>] [--compare <file>] -- <command> <options>")
+            .Flush();
+        exit_status_ = 1;
+
+        return;
+    }
+
+    std::uint64_t count{BENCH_COUNT};
+    std::size_t window{0};
+    std::size_t trials{0};
+    std::string output{};
+    std::string compare{};
+    LoadGenerator::Pacing pacing{};
+
+    po::options_description options("Options");
+    options.add_options()(
+        "count", po::value<std::uint64_t>(&count), "<number>");
+    options.add_options()(
+        "window", po::value<std::size_t>(&window), "<number>");
+    options.add_options()(
+        "rate",
+        po::value<double>(&pacing.rate_),
+        "<number> Commands per second");
+    options.add_options()(
+        "trials", po::value<std::size_t>(&trials), "<number>");
+    options.add_options()("output", po::value<std::string>(&output), "<file>");
+    options.add_options()(
+        "compare", po::value<std::string>(&compare), "<file>");
+    parse_command(in.substr(0, separator), options);
+
+    if (0 == window) {
+        window = (0 < pacing.rate_) ? static_cast<std::size_t>(count)
+                                    : std::size_t{BENCH_WINDOW};
+    }
+
+    // Results which are saved or compared need enough trials for a t-test
+    if (0 == trials) {
+        const auto stored =
+            (false == output.empty()) || (false == compare.empty());
+        trials = stored ? std::size_t{BENCH_TRIALS} : std::size_t{1};
+    }
+
+    const auto line = in.substr(separator + 4);
+    const auto name = line.substr(0, line.find(" "));
+    std::vector<proto::RPCCommand> commands{};
+
+    if (false == capture(line, commands)) {
+        exit_status_ = 1;
+
+        return;
+    }
+
+    std::vector<BenchReport::Trial> results{};
+    Histogram latency{LoadGenerator::HighestLatency};
+    std::map<proto::RPCResponseCode, std::uint64_t> status{};
+
+    for (std::size_t trial{1}; trial <= trials; ++trial) {
+        const auto result =
+            start_load(commands)->Run(socket, count, window, pacing);
+        stop_load();
+        const auto seconds =
+            std::chrono::duration<double>(result.elapsed_).count();
+        BenchReport::Trial item{};
+        item.sent_ = result.sent_;
+        item.received_ = result.received_;
+        item.throughput_ =
+            (0 < seconds) ? static_cast<double>(result.received_) / seconds
+                          : 0.0;
+        item.p50_ = static_cast<double>(result.latency_.ValueAt(0.5)) / 1000;
+        item.p90_ = static_cast<double>(result.latency_.ValueAt(0.9)) / 1000;
+        item.p99_ = static_cast<double>(result.latency_.ValueAt(0.99)) / 1000;
+        item.p999_ =
+            static_cast<double>(result.latency_.ValueAt(0.999)) / 1000;
+        results.emplace_back(item);
+        latency.Merge(result.latency_);
+
+        for (const auto& [code, total] : result.status_) {
+            status[code] += total;
+        }
+
+        std::stringstream out{};
+
+        if (1 < trials) { out << "Trial " << trial << ": "; }
+
+        out << "Sent " << result.sent_ << ", received " << result.received_
+            << " in " << seconds << " s (" << item.throughput_
+            << " replies/s)";
+        LogOutput(out.str()).Flush();
+    }
+
+    LogOutput(summarize(latency, status)).Flush();
+
+    if (false == output.empty()) {
+        char host[256]{};
+        ::gethostname(host, sizeof(host) - 1);
+        const BenchReport::Environment environment{
+            {"host", host},
+            {"endpoint", endpoint_},
+            {"cpus", std::to_string(std::thread::hardware_concurrency())},
+            {"time", std::to_string(std::time(nullptr))},
+            {"count", std::to_string(count)},
+            {"window", std::to_string(window)},
+            {"rate", std::to_string(pacing.rate_)},
+        };
+
+        if (false ==
+            BenchReport::Save(output, name, line, environment, results)) {
+            exit_status_ = 1;
+        }
+    }
+
+    if (false == compare.empty()) {
+        std::vector<BenchReport::Trial> baseline{};
+
+        if (false == BenchReport::Load(compare, name, baseline)) {
+            exit_status_ = 1;
+
+            return;
+        }
+
+        std::string table{};
+        const auto regressed = BenchReport::Compare(baseline, results, table);
+        LogOutput("Compared with ")(compare)(":\n")(table).Flush();
+
+        // A comparison which could not be made must not pass the gate
+        if ((2 > baseline.size()) || (2 > results.size())) {
+            exit_status_ = 1;
+        } else if (regressed) {
+            LogOutput(__FUNCTION__)(": ")(name)(" regressed").Flush();
+            exit_status_ = 1;
+        }
+    }
+}
+
 void CLI::callback(zmq::Message& in)
 {
     const auto size = in.Body().size();
@@ -506,6 +988,49 @@ void CLI::callback(zmq::Message& in)
     }
 }
 
+// Runs a command line through its processor and collects the commands it
+// would have sent instead of sending them
+bool CLI::capture(
+    const std::string& line,
+    std::vector<proto::RPCCommand>& commands)
+{
+    const auto name = line.substr(0, line.find(" "));
+    const auto command = commands_.find(name);
+
+    if (commands_.end() == command) {
+        LogOutput(__FUNCTION__)(": Unknown command ")(name).Flush();
+
+        return false;
+    }
+
+    {
+        Lock lock(capture_lock_);
+        capture_ = &commands;
+        capturing_ = std::this_thread::get_id();
+    }
+
+    try {
+        const auto processor = processors_.at(command->second);
+        (this->*processor)(line, socket_);
+    } catch (const po::error& err) {
+        LogOutput(__FUNCTION__)(": ")(err.what()).Flush();
+    }
+
+    {
+        Lock lock(capture_lock_);
+        capture_ = nullptr;
+        capturing_ = std::thread::id{};
+    }
+
+    if (commands.empty()) {
+        LogOutput(__FUNCTION__)(": ")(name)(" produced no commands").Flush();
+
+        return false;
+    }
+
+    return true;
+}
+
 void CLI::create_account(
     const std::string& in,
     const zmq::socket::Dealer& socket)
@@ -555,14 +1080,14 @@ void CLI::create_account(
 
     proto::RPCCommand command{};
     command.set_version(RPC_COMMAND_VERSION);
-    command.set_cookie(Identifier::Random()->str());
+    command.set_cookie(cookies_.Next());
     command.set_type(proto::RPCCOMMAND_CREATEACCOUNT);
     command.set_session(instance);
     command.set_owner(owner);
     command.set_notary(server);
     command.set_unit(unitDefinition);
 
-    const auto valid = proto::Validate(command, VERBOSE);
+    const auto valid = validate(command);
 
     OT_ASSERT(valid)
 
@@ -620,12 +1145,12 @@ void CLI::create_compatible_account(
 
     proto::RPCCommand out{};
     out.set_version(RPC_COMMAND_VERSION);
-    out.set_cookie(Identifier::Random()->str());
+    out.set_cookie(cookies_.Next());
     out.set_type(proto::RPCCOMMAND_CREATECOMPATIBLEACCOUNT);
     out.set_session(instance);
     out.set_owner(nymID);
     out.add_identifier(workflowID);
-    const auto valid = proto::Validate(out, VERBOSE);
+    const auto valid = validate(out);
 
     OT_ASSERT(valid)
 
@@ -669,7 +1194,7 @@ void CLI::create_nym(const std::string& in, const zmq::socket::Dealer& socket)
 
     proto::RPCCommand out{};
     out.set_version(RPC_COMMAND_VERSION);
-    out.set_cookie(Identifier::Random()->str());
+    out.set_cookie(cookies_.Next());
     out.set_type(proto::RPCCOMMAND_CREATENYM);
     out.set_session(instance);
     auto& create = *out.mutable_createnym();
@@ -678,7 +1203,7 @@ void CLI::create_nym(const std::string& in, const zmq::socket::Dealer& socket)
     create.set_name(name);
     create.set_seedid(seed);
     create.set_index(index);
-    const auto valid = proto::Validate(out, VERBOSE);
+    const auto valid = validate(out);
 
     OT_ASSERT(valid)
 
@@ -808,7 +1333,7 @@ void CLI::create_unit_definition(
 
     proto::RPCCommand out{};
     out.set_version(RPC_COMMAND_VERSION);
-    out.set_cookie(Identifier::Random()->str());
+    out.set_cookie(cookies_.Next());
     out.set_type(proto::RPCCOMMAND_CREATEUNITDEFINITION);
     out.set_session(instance);
     out.set_owner(nymID);
@@ -823,7 +1348,7 @@ void CLI::create_unit_definition(
     create.set_terms(terms);
     create.set_unitofaccount(
         static_cast<proto::ContactItemType>(unitOfAccount));
-    const auto valid = proto::Validate(out, VERBOSE);
+    const auto valid = validate(out);
 
     OT_ASSERT(valid)
 
@@ -869,6 +1394,74 @@ std::string CLI::find_home()
     return output;
 }
 
+// Answers lookups of immutable contracts locally by replaying a reply built
+// from the cache through the normal response handler
+bool CLI::from_cache(
+    const proto::RPCCommandType type,
+    const int instance,
+    const std::string& id)
+{
+    if (false == bool(cache_)) { return false; }
+
+    std::string bytes{};
+    proto::RPCResponse response{};
+
+    switch (type) {
+        case proto::RPCCOMMAND_GETNYM: {
+            if (false == cache_->Get(ObjectCache::Type::Nym, id, bytes)) {
+                return false;
+            }
+
+            auto& nym = *response.add_nym();
+
+            if ((false == nym.ParseFromString(bytes)) || (id != nym.nymid())) {
+                return false;
+            }
+        } break;
+        case proto::RPCCOMMAND_GETSERVERCONTRACT: {
+            if (false == cache_->Get(ObjectCache::Type::Server, id, bytes)) {
+                return false;
+            }
+
+            auto& server = *response.add_notary();
+
+            if ((false == server.ParseFromString(bytes)) ||
+                (id != server.id())) {
+                return false;
+            }
+        } break;
+        case proto::RPCCOMMAND_GETUNITDEFINITION: {
+            if (false == cache_->Get(ObjectCache::Type::Unit, id, bytes)) {
+                return false;
+            }
+
+            auto& unit = *response.add_unit();
+
+            if ((false == unit.ParseFromString(bytes)) || (id != unit.id())) {
+                return false;
+            }
+        } break;
+        default: {
+            return false;
+        }
+    }
+
+    response.set_version(RPC_COMMAND_VERSION);
+    response.set_cookie(cookies_.Next());
+    response.set_type(type);
+    response.set_session(instance);
+    auto& status = *response.add_status();
+    status.set_version(RPC_STATUS_VERSION);
+    status.set_index(0);
+    status.set_code(proto::RPCRESPONSE_SUCCESS);
+    LogOutput(" * Using cached ")(get_command_name(type))(" result for ")(id)
+        .Flush();
+    const auto handler = response_handlers_.at(type);
+    (this->*handler)(response);
+
+    return true;
+}
+
 std::string CLI::get_command_name(const proto::RPCCommandType type)
 {
     try {
@@ -918,12 +1511,12 @@ void CLI::get_compatible_accounts(
 
     proto::RPCCommand out{};
     out.set_version(RPC_COMMAND_VERSION);
-    out.set_cookie(Identifier::Random()->str());
+    out.set_cookie(cookies_.Next());
     out.set_type(proto::RPCCOMMAND_GETCOMPATIBLEACCOUNTS);
     out.set_session(instance);
     out.set_owner(nymID);
     out.add_identifier(workflowID);
-    const auto valid = proto::Validate(out, VERBOSE);
+    const auto valid = validate(out);
 
     OT_ASSERT(valid)
 
@@ -944,15 +1537,15 @@ void CLI::get_compatible_accounts_response(const proto::RPCResponse& in)
 
 std::string CLI::get_json(const po::variables_map& cli)
 {
-    std::string filename{};
     const auto& cliValue = cli["keyfile"];
 
-    if (cliValue.empty()) {
-        filename = find_home() + "/otagent.key";
-    } else {
-        filename = cli["keyfile"].as<std::string>();
-    }
+    if (cliValue.empty()) { return get_json(find_home() + "/otagent.key"); }
+
+    return get_json(cli["keyfile"].as<std::string>());
+}
 
+std::string CLI::get_json(const std::string& filename)
+{
     boost::system::error_code ec{};
 
     if (false == boost::filesystem::exists(filename, ec)) { return {}; }
@@ -981,12 +1574,19 @@ void CLI::get_account_activity(
     const zmq::socket::Dealer& socket)
 {
     int instance{-1};
-    std::string accountID{""};
+    std::vector<std::string> accounts{};
+    std::string file{""};
+    std::size_t batchSize{BATCH_SIZE};
 
     po::options_description options("Options");
     options.add_options()("instance", po::value<int>(&instance), "<number>");
     options.add_options()(
-        "account", po::value<std::string>(&accountID), "<string>");
+        "account",
+        po::value<std::vector<std::string>>(&accounts)->multitoken(),
+        "<string>...");
+    options.add_options()("file", po::value<std::string>(&file), "<path>");
+    options.add_options()(
+        "batchsize", po::value<std::size_t>(&batchSize), "<number>");
     auto hasOptions = parse_command(in, options);
 
     if (!hasOptions) {
@@ -1000,32 +1600,58 @@ void CLI::get_account_activity(
         return;
     }
 
-    if (accountID.empty()) {
+    if ((false == file.empty()) && (false == read_items(file, accounts))) {
+        LogOutput(__FUNCTION__)(": Unable to read ")(file).Flush();
+
+        return;
+    }
+
+    if (accounts.empty()) {
         LogOutput(__FUNCTION__)(": Missing account id option").Flush();
 
         return;
     }
 
-    proto::RPCCommand out{};
-    out.set_version(RPC_COMMAND_VERSION);
-    out.set_cookie(Identifier::Random()->str());
-    out.set_type(proto::RPCCOMMAND_GETACCOUNTACTIVITY);
-    out.set_session(instance);
-    out.add_identifier(accountID);
-    const auto valid = proto::Validate(out, VERBOSE);
+    batchSize = std::max(batchSize, std::size_t{1});
 
-    OT_ASSERT(valid)
+    for (std::size_t first{0}; first < accounts.size(); first += batchSize) {
+        const auto last = std::min(accounts.size(), first + batchSize);
+        proto::RPCCommand out{};
+        out.set_version(RPC_COMMAND_VERSION);
+        out.set_cookie(cookies_.Next());
+        out.set_type(proto::RPCCOMMAND_GETACCOUNTACTIVITY);
+        out.set_session(instance);
 
-    const auto sent = send_message(socket, out);
+        for (auto i = first; i < last; ++i) {
+            out.add_identifier(accounts.at(i));
+        }
 
-    OT_ASSERT(sent)
+        const auto valid = validate(out);
+
+        OT_ASSERT(valid)
+
+        set_batch(
+            out.cookie(), {accounts.begin() + first, accounts.begin() + last});
+        const auto sent = send_message(socket, out);
+
+        OT_ASSERT(sent)
+    }
 }
 
 void CLI::get_account_activity_response(const proto::RPCResponse& in)
 {
     print_basic_info(in);
+    print_items(in);
+
+    std::size_t unchanged{0};
 
     for (const auto& accountevent : in.accountevent()) {
+        if (activity_ && (false == activity_->Update(accountevent))) {
+            ++unchanged;
+
+            continue;
+        }
+
         LogOutput("   Account ID: ")(accountevent.id()).Flush();
         LogOutput("   Workflow ID: ")(accountevent.workflow()).Flush();
         LogOutput("   Amount: ")(accountevent.amount()).Flush();
@@ -1033,6 +1659,11 @@ void CLI::get_account_activity_response(const proto::RPCResponse& in)
         LogOutput("   Memo: ")(accountevent.memo()).Flush();
         LogOutput("   UUID: ")(accountevent.uuid()).Flush();
     }
+
+    if (0 < unchanged) {
+        LogOutput("   ")(unchanged)(" events unchanged since the last poll")
+            .Flush();
+    }
 }
 
 void CLI::get_account_balance(
@@ -1040,12 +1671,19 @@ void CLI::get_account_balance(
     const zmq::socket::Dealer& socket)
 {
     int instance{-1};
-    std::string accountID{""};
+    std::vector<std::string> accounts{};
+    std::string file{""};
+    std::size_t batchSize{BATCH_SIZE};
 
     po::options_description options("Options");
     options.add_options()("instance", po::value<int>(&instance), "<number>");
     options.add_options()(
-        "account", po::value<std::string>(&accountID), "<string>");
+        "account",
+        po::value<std::vector<std::string>>(&accounts)->multitoken(),
+        "<string>...");
+    options.add_options()("file", po::value<std::string>(&file), "<path>");
+    options.add_options()(
+        "batchsize", po::value<std::size_t>(&batchSize), "<number>");
     auto hasOptions = parse_command(in, options);
 
     if (!hasOptions) {
@@ -1059,30 +1697,48 @@ void CLI::get_account_balance(
         return;
     }
 
-    if (accountID.empty()) {
+    if ((false == file.empty()) && (false == read_items(file, accounts))) {
+        LogOutput(__FUNCTION__)(": Unable to read ")(file).Flush();
+
+        return;
+    }
+
+    if (accounts.empty()) {
         LogOutput(__FUNCTION__)(": Missing acount id option").Flush();
 
         return;
     }
 
-    proto::RPCCommand out{};
-    out.set_version(RPC_COMMAND_VERSION);
-    out.set_cookie(Identifier::Random()->str());
-    out.set_type(proto::RPCCOMMAND_GETACCOUNTBALANCE);
-    out.set_session(instance);
-    out.add_identifier(accountID);
-    const auto valid = proto::Validate(out, VERBOSE);
+    batchSize = std::max(batchSize, std::size_t{1});
 
-    OT_ASSERT(valid)
+    for (std::size_t first{0}; first < accounts.size(); first += batchSize) {
+        const auto last = std::min(accounts.size(), first + batchSize);
+        proto::RPCCommand out{};
+        out.set_version(RPC_COMMAND_VERSION);
+        out.set_cookie(cookies_.Next());
+        out.set_type(proto::RPCCOMMAND_GETACCOUNTBALANCE);
+        out.set_session(instance);
 
-    const auto sent = send_message(socket, out);
+        for (auto i = first; i < last; ++i) {
+            out.add_identifier(accounts.at(i));
+        }
 
-    OT_ASSERT(sent)
+        const auto valid = validate(out);
+
+        OT_ASSERT(valid)
+
+        set_batch(
+            out.cookie(), {accounts.begin() + first, accounts.begin() + last});
+        const auto sent = send_message(socket, out);
+
+        OT_ASSERT(sent)
+    }
 }
 
 void CLI::get_account_balance_response(const proto::RPCResponse& in)
 {
     print_basic_info(in);
+    print_items(in);
 
     for (const auto& accountdata : in.balance()) {
 
@@ -1129,13 +1785,15 @@ void CLI::get_nym(const std::string& in, const zmq::socket::Dealer& socket)
         return;
     }
 
+    if (from_cache(proto::RPCCOMMAND_GETNYM, instance, ownerID)) { return; }
+
     proto::RPCCommand out{};
     out.set_version(RPC_COMMAND_VERSION);
-    out.set_cookie(Identifier::Random()->str());
+    out.set_cookie(cookies_.Next());
     out.set_type(proto::RPCCOMMAND_GETNYM);
     out.set_session(instance);
     out.add_identifier(ownerID);
-    const auto valid = proto::Validate(out, VERBOSE);
+    const auto valid = validate(out);
 
     OT_ASSERT(valid)
 
@@ -1149,6 +1807,13 @@ void CLI::get_nym_response(const proto::RPCResponse& in)
     print_basic_info(in);
 
     for (const auto& credentialindex : in.nym()) {
+        if (cache_ && (false == credentialindex.nymid().empty())) {
+            cache_->Put(
+                ObjectCache::Type::Nym,
+                credentialindex.nymid(),
+                credentialindex.SerializeAsString());
+        }
+
         LogOutput("   Nym ID: ")(credentialindex.nymid()).Flush();
         LogOutput("   Revision: ")(credentialindex.revision()).Flush();
         LogOutput("   Active Credential Count: ")(
@@ -1192,11 +1857,11 @@ void CLI::get_pending_payments(
 
     proto::RPCCommand out{};
     out.set_version(RPC_COMMAND_VERSION);
-    out.set_cookie(Identifier::Random()->str());
+    out.set_cookie(cookies_.Next());
     out.set_type(proto::RPCCOMMAND_GETPENDINGPAYMENTS);
     out.set_session(instance);
     out.set_owner(ownerID);
-    const auto valid = proto::Validate(out, VERBOSE);
+    const auto valid = validate(out);
 
     OT_ASSERT(valid)
 
@@ -1250,11 +1915,11 @@ void CLI::get_seed(const std::string& in, const zmq::socket::Dealer& socket)
 
     proto::RPCCommand out{};
     out.set_version(RPC_COMMAND_VERSION);
-    out.set_cookie(Identifier::Random()->str());
+    out.set_cookie(cookies_.Next());
     out.set_type(proto::RPCCOMMAND_GETHDSEED);
     out.set_session(instance);
     out.add_identifier(seedID);
-    const auto valid = proto::Validate(out, VERBOSE);
+    const auto valid = validate(out);
 
     OT_ASSERT(valid)
 
@@ -1304,13 +1969,17 @@ void CLI::get_server_contract(
         return;
     }
 
+    if (from_cache(proto::RPCCOMMAND_GETSERVERCONTRACT, instance, serverID)) {
+        return;
+    }
+
     proto::RPCCommand out{};
     out.set_version(RPC_COMMAND_VERSION);
-    out.set_cookie(Identifier::Random()->str());
+    out.set_cookie(cookies_.Next());
     out.set_type(proto::RPCCOMMAND_GETSERVERCONTRACT);
     out.set_session(instance);
     out.add_identifier(serverID);
-    const auto valid = proto::Validate(out, VERBOSE);
+    const auto valid = validate(out);
 
     OT_ASSERT(valid)
 
@@ -1324,6 +1993,11 @@ void CLI::get_server_contract_response(const proto::RPCResponse& in)
     print_basic_info(in);
 
     for (const auto& id : in.notary()) {
+        if (cache_ && (false == id.id().empty())) {
+            cache_->Put(
+                ObjectCache::Type::Server, id.id(), id.SerializeAsString());
+        }
+
         // TODO it's not possible to construct an opentxs::Armored object
         // without a client session auto output = proto::ProtoAsArmored(id,
         // String::Factory("SERVER CONTRACT"));
@@ -1408,11 +2082,11 @@ void CLI::get_transaction_data(
 
     proto::RPCCommand out{};
     out.set_version(RPC_COMMAND_VERSION);
-    out.set_cookie(Identifier::Random()->str());
+    out.set_cookie(cookies_.Next());
     out.set_type(proto::RPCCOMMAND_GETTRANSACTIONDATA);
     out.set_session(instance);
     out.add_identifier(uuid);
-    const auto valid = proto::Validate(out, VERBOSE);
+    const auto valid = validate(out);
 
     OT_ASSERT(valid)
 
@@ -1442,17 +2116,17 @@ void CLI::get_transaction_data_response(const proto::RPCResponse& in)
     }
 }
 
-void CLI::get_workflow(const std::string& in, const zmq::socket::Dealer& socket)
+void CLI::get_unit_definition(
+    const std::string& in,
+    const zmq::socket::Dealer& socket)
 {
     int instance{-1};
-    std::string nymID{""};
-    std::string workflowID{""};
+    std::string unitID{""};
 
     po::options_description options("Options");
     options.add_options()("instance", po::value<int>(&instance), "<number>");
-    options.add_options()("nym", po::value<std::string>(&nymID), "<string>");
     options.add_options()(
-        "workflow", po::value<std::string>(&workflowID), "<string>");
+        "unitdefinition", po::value<std::string>(&unitID), "<string>");
     auto hasOptions = parse_command(in, options);
 
     if (!hasOptions) {
@@ -1466,28 +2140,23 @@ void CLI::get_workflow(const std::string& in, const zmq::socket::Dealer& socket)
         return;
     }
 
-    if (nymID.empty()) {
-        LogOutput(__FUNCTION__)(": Missing nym id option").Flush();
+    if (unitID.empty()) {
+        LogOutput(__FUNCTION__)(": Missing unit definition id option").Flush();
 
         return;
     }
 
-    if (workflowID.empty()) {
-        LogOutput(__FUNCTION__)(": Missing workflow id option").Flush();
-
+    if (from_cache(proto::RPCCOMMAND_GETUNITDEFINITION, instance, unitID)) {
         return;
     }
 
     proto::RPCCommand out{};
     out.set_version(RPC_COMMAND_VERSION);
-    out.set_cookie(Identifier::Random()->str());
-    out.set_type(proto::RPCCOMMAND_GETWORKFLOW);
+    out.set_cookie(cookies_.Next());
+    out.set_type(proto::RPCCOMMAND_GETUNITDEFINITION);
     out.set_session(instance);
-    auto& getworkflow = *out.add_getworkflow();
-    getworkflow.set_version(GETWORKFLOW_VERSION);
-    getworkflow.set_nymid(nymID);
-    getworkflow.set_workflowid(workflowID);
-    const auto valid = proto::Validate(out, VERBOSE);
+    out.add_identifier(unitID);
+    const auto valid = validate(out);
 
     OT_ASSERT(valid)
 
@@ -1496,9 +2165,106 @@ void CLI::get_workflow(const std::string& in, const zmq::socket::Dealer& socket)
     OT_ASSERT(sent)
 }
 
+void CLI::get_unit_definition_response(const proto::RPCResponse& in)
+{
+    print_basic_info(in);
+
+    for (const auto& unit : in.unit()) {
+        if (cache_ && (false == unit.id().empty())) {
+            cache_->Put(
+                ObjectCache::Type::Unit, unit.id(), unit.SerializeAsString());
+        }
+
+        LogOutput("   Unit Definition ID: ")(unit.id()).Flush();
+        LogOutput("   Issuer Nym ID: ")(unit.nymid()).Flush();
+        LogOutput("   Short Name: ")(unit.shortname()).Flush();
+        LogOutput("   Terms: ")(unit.terms()).Flush();
+    }
+}
+
+void CLI::get_workflow(const std::string& in, const zmq::socket::Dealer& socket)
+{
+    int instance{-1};
+    std::string nymID{""};
+    std::vector<std::string> workflows{};
+    std::string file{""};
+    std::size_t batchSize{BATCH_SIZE};
+
+    po::options_description options("Options");
+    options.add_options()("instance", po::value<int>(&instance), "<number>");
+    options.add_options()("nym", po::value<std::string>(&nymID), "<string>");
+    options.add_options()(
+        "workflow",
+        po::value<std::vector<std::string>>(&workflows)->multitoken(),
+        "<string>...");
+    options.add_options()("file", po::value<std::string>(&file), "<path>");
+    options.add_options()(
+        "batchsize", po::value<std::size_t>(&batchSize), "<number>");
+    auto hasOptions = parse_command(in, options);
+
+    if (!hasOptions) {
+        print_options_description(options);
+        return;
+    }
+
+    if (-1 == instance) {
+        LogOutput(__FUNCTION__)(": Missing instance option").Flush();
+
+        return;
+    }
+
+    if (nymID.empty()) {
+        LogOutput(__FUNCTION__)(": Missing nym id option").Flush();
+
+        return;
+    }
+
+    if ((false == file.empty()) && (false == read_items(file, workflows))) {
+        LogOutput(__FUNCTION__)(": Unable to read ")(file).Flush();
+
+        return;
+    }
+
+    if (workflows.empty()) {
+        LogOutput(__FUNCTION__)(": Missing workflow id option").Flush();
+
+        return;
+    }
+
+    batchSize = std::max(batchSize, std::size_t{1});
+
+    for (std::size_t first{0}; first < workflows.size(); first += batchSize) {
+        const auto last = std::min(workflows.size(), first + batchSize);
+        proto::RPCCommand out{};
+        out.set_version(RPC_COMMAND_VERSION);
+        out.set_cookie(cookies_.Next());
+        out.set_type(proto::RPCCOMMAND_GETWORKFLOW);
+        out.set_session(instance);
+
+        for (auto i = first; i < last; ++i) {
+            auto& getworkflow = *out.add_getworkflow();
+            getworkflow.set_version(GETWORKFLOW_VERSION);
+            getworkflow.set_nymid(nymID);
+            getworkflow.set_workflowid(workflows.at(i));
+        }
+
+        const auto valid = validate(out);
+
+        OT_ASSERT(valid)
+
+        set_batch(
+            out.cookie(),
+            {workflows.begin() + first, workflows.begin() + last});
+        const auto sent = send_message(socket, out);
+
+        OT_ASSERT(sent)
+    }
+}
+
 void CLI::get_workflow_response(const proto::RPCResponse& in)
 {
     print_basic_info(in);
+    print_items(in);
 
     for (const auto& workflow : in.workflow()) {
         LogOutput(__FUNCTION__)(": Version ")(workflow.version())(" workflow")
@@ -1590,7 +2356,7 @@ void CLI::import_seed(const std::string& in, const zmq::socket::Dealer& socket)
 
     proto::RPCCommand command{};
     command.set_version(RPC_COMMAND_VERSION);
-    command.set_cookie(Identifier::Random()->str());
+    command.set_cookie(cookies_.Next());
     command.set_type(proto::RPCCOMMAND_IMPORTHDSEED);
     command.set_session(instance);
     auto& seed = *command.mutable_hdseed();
@@ -1598,7 +2364,7 @@ void CLI::import_seed(const std::string& in, const zmq::socket::Dealer& socket)
     seed.set_words(words);
     seed.set_passphrase(passphrase);
 
-    const auto valid = proto::Validate(command, VERBOSE);
+    const auto valid = validate(command);
 
     OT_ASSERT(valid)
 
@@ -1650,14 +2416,14 @@ void CLI::import_server_contract(
 
     proto::RPCCommand command{};
     command.set_version(RPC_COMMAND_VERSION);
-    command.set_cookie(Identifier::Random()->str());
+    command.set_cookie(cookies_.Next());
     command.set_type(proto::RPCCOMMAND_IMPORTSERVERCONTRACT);
     command.set_session(instance);
     auto& server = *command.add_server();
     server = proto::StringToProto<proto::ServerContract>(
         String::Factory(input.c_str()));
 
-    const auto valid = proto::Validate(command, VERBOSE);
+    const auto valid = validate(command);
 
     OT_ASSERT(valid)
 
@@ -1720,14 +2486,14 @@ void CLI::issue_unit_definition(
 
     proto::RPCCommand command{};
     command.set_version(RPC_COMMAND_VERSION);
-    command.set_cookie(Identifier::Random()->str());
+    command.set_cookie(cookies_.Next());
     command.set_type(proto::RPCCOMMAND_ISSUEUNITDEFINITION);
     command.set_session(instance);
     command.set_owner(owner);
     command.set_notary(server);
     command.set_unit(unitDefinition);
 
-    const auto valid = proto::Validate(command, VERBOSE);
+    const auto valid = validate(command);
 
     OT_ASSERT(valid)
 
@@ -1750,9 +2516,11 @@ void CLI::list_accounts(
     const zmq::socket::Dealer& socket)
 {
     int instance{-1};
+    Page page{};
 
     po::options_description options("Options");
     options.add_options()("instance", po::value<int>(&instance), "<number>");
+    add_page_options(options, page);
     auto hasOptions = parse_command(in, options);
 
     if (!hasOptions) {
@@ -1768,13 +2536,14 @@ void CLI::list_accounts(
 
     proto::RPCCommand out{};
     out.set_version(RPC_COMMAND_VERSION);
-    out.set_cookie(Identifier::Random()->str());
+    out.set_cookie(cookies_.Next());
     out.set_type(proto::RPCCOMMAND_LISTACCOUNTS);
     out.set_session(instance);
-    const auto valid = proto::Validate(out, VERBOSE);
+    const auto valid = validate(out);
 
     OT_ASSERT(valid)
 
+    set_page(out.cookie(), page);
     const auto sent = send_message(socket, out);
 
     OT_ASSERT(sent)
@@ -1783,10 +2552,7 @@ void CLI::list_accounts(
 void CLI::list_accounts_response(const proto::RPCResponse& in)
 {
     print_basic_info(in);
-
-    for (const auto& id : in.identifier()) {
-        LogOutput("   Account ID: ")(id).Flush();
-    }
+    print_page(in, "   Account ID: ");
 }
 
 void CLI::list_client_sessions(
@@ -1795,10 +2561,10 @@ void CLI::list_client_sessions(
 {
     proto::RPCCommand out{};
     out.set_version(RPC_COMMAND_VERSION);
-    out.set_cookie(Identifier::Random()->str());
+    out.set_cookie(cookies_.Next());
     out.set_type(proto::RPCCOMMAND_LISTCLIENTSESSIONS);
     out.set_session(-1);
-    const auto valid = proto::Validate(out, VERBOSE);
+    const auto valid = validate(out);
 
     OT_ASSERT(valid)
 
@@ -1812,9 +2578,11 @@ void CLI::list_contacts(
     const zmq::socket::Dealer& socket)
 {
     int instance{-1};
+    Page page{};
 
     po::options_description options("Options");
     options.add_options()("instance", po::value<int>(&instance), "<number>");
+    add_page_options(options, page);
     auto hasOptions = parse_command(in, options);
 
     if (!hasOptions) {
@@ -1830,13 +2598,14 @@ void CLI::list_contacts(
 
     proto::RPCCommand out{};
     out.set_version(RPC_COMMAND_VERSION);
-    out.set_cookie(Identifier::Random()->str());
+    out.set_cookie(cookies_.Next());
     out.set_type(proto::RPCCOMMAND_LISTCONTACTS);
     out.set_session(instance);
-    const auto valid = proto::Validate(out, VERBOSE);
+    const auto valid = validate(out);
 
     OT_ASSERT(valid)
 
+    set_page(out.cookie(), page);
     const auto sent = send_message(socket, out);
 
     OT_ASSERT(sent)
@@ -1845,18 +2614,17 @@ void CLI::list_contacts(
 void CLI::list_contacts_response(const proto::RPCResponse& in)
 {
     print_basic_info(in);
-
-    for (const auto& id : in.identifier()) {
-        LogOutput("   Contact ID: ")(id).Flush();
-    }
+    print_page(in, "   Contact ID: ");
 }
 
 void CLI::list_nyms(const std::string& in, const zmq::socket::Dealer& socket)
 {
     int instance{-1};
+    Page page{};
 
     po::options_description options("Options");
     options.add_options()("instance", po::value<int>(&instance), "<number>");
+    add_page_options(options, page);
     auto hasOptions = parse_command(in, options);
 
     if (!hasOptions) {
@@ -1872,13 +2640,14 @@ void CLI::list_nyms(const std::string& in, const zmq::socket::Dealer& socket)
 
     proto::RPCCommand out{};
     out.set_version(RPC_COMMAND_VERSION);
-    out.set_cookie(Identifier::Random()->str());
+    out.set_cookie(cookies_.Next());
     out.set_type(proto::RPCCOMMAND_LISTNYMS);
     out.set_session(instance);
-    const auto valid = proto::Validate(out, VERBOSE);
+    const auto valid = validate(out);
 
     OT_ASSERT(valid)
 
+    set_page(out.cookie(), page);
     const auto sent = send_message(socket, out);
 
     OT_ASSERT(sent)
@@ -1887,18 +2656,17 @@ void CLI::list_nyms(const std::string& in, const zmq::socket::Dealer& socket)
 void CLI::list_nyms_response(const proto::RPCResponse& in)
 {
     print_basic_info(in);
-
-    for (const auto& id : in.identifier()) {
-        LogOutput("   Nym ID: ")(id).Flush();
-    }
+    print_page(in, "   Nym ID: ");
 }
 
 void CLI::list_seeds(const std::string& in, const zmq::socket::Dealer& socket)
 {
     int instance{-1};
+    Page page{};
 
     po::options_description options("Options");
     options.add_options()("instance", po::value<int>(&instance), "<number>");
+    add_page_options(options, page);
     auto hasOptions = parse_command(in, options);
 
     if (!hasOptions) {
@@ -1914,13 +2682,14 @@ void CLI::list_seeds(const std::string& in, const zmq::socket::Dealer& socket)
 
     proto::RPCCommand out{};
     out.set_version(RPC_COMMAND_VERSION);
-    out.set_cookie(Identifier::Random()->str());
+    out.set_cookie(cookies_.Next());
     out.set_type(proto::RPCCOMMAND_LISTHDSEEDS);
     out.set_session(instance);
-    const auto valid = proto::Validate(out, VERBOSE);
+    const auto valid = validate(out);
 
     OT_ASSERT(valid)
 
+    set_page(out.cookie(), page);
     const auto sent = send_message(socket, out);
 
     OT_ASSERT(sent)
@@ -1929,10 +2698,7 @@ void CLI::list_seeds(const std::string& in, const zmq::socket::Dealer& socket)
 void CLI::list_seeds_response(const proto::RPCResponse& in)
 {
     print_basic_info(in);
-
-    for (const auto& id : in.identifier()) {
-        LogOutput("   Seed ID: ")(id).Flush();
-    }
+    print_page(in, "   Seed ID: ");
 }
 
 void CLI::list_server_contracts(
@@ -1940,8 +2706,11 @@ void CLI::list_server_contracts(
     const zmq::socket::Dealer& socket)
 {
     int instance{-1};
+    Page page{};
+
     po::options_description options("Options");
     options.add_options()("instance", po::value<int>(&instance), "<number>");
+    add_page_options(options, page);
     auto hasOptions = parse_command(in, options);
 
     if (!hasOptions) {
@@ -1957,13 +2726,14 @@ void CLI::list_server_contracts(
 
     proto::RPCCommand out{};
     out.set_version(RPC_COMMAND_VERSION);
-    out.set_cookie(Identifier::Random()->str());
+    out.set_cookie(cookies_.Next());
     out.set_type(proto::RPCCOMMAND_LISTSERVERCONTRACTS);
     out.set_session(instance);
-    const auto valid = proto::Validate(out, VERBOSE);
+    const auto valid = validate(out);
 
     OT_ASSERT(valid)
 
+    set_page(out.cookie(), page);
     const auto sent = send_message(socket, out);
 
     OT_ASSERT(sent)
@@ -1975,10 +2745,10 @@ void CLI::list_server_sessions(
 {
     proto::RPCCommand out{};
     out.set_version(RPC_COMMAND_VERSION);
-    out.set_cookie(Identifier::Random()->str());
+    out.set_cookie(cookies_.Next());
     out.set_type(proto::RPCCOMMAND_LISTSERVERSESSIONS);
     out.set_session(-1);
-    const auto valid = proto::Validate(out, VERBOSE);
+    const auto valid = validate(out);
 
     OT_ASSERT(valid)
 
@@ -1990,10 +2760,7 @@ void CLI::list_server_sessions(
 void CLI::list_servers_response(const proto::RPCResponse& in)
 {
     print_basic_info(in);
-
-    for (const auto& id : in.identifier()) {
-        LogOutput("   Notary: ")(id).Flush();
-    }
+    print_page(in, "   Notary: ");
 }
 
 void CLI::list_session_response(const proto::RPCResponse& in)
@@ -2010,9 +2777,11 @@ void CLI::list_unit_definitions(
     const zmq::socket::Dealer& socket)
 {
     int instance{-1};
+    Page page{};
 
     po::options_description options("Options");
     options.add_options()("instance", po::value<int>(&instance), "<number>");
+    add_page_options(options, page);
     auto hasOptions = parse_command(in, options);
 
     if (!hasOptions) {
@@ -2028,13 +2797,14 @@ void CLI::list_unit_definitions(
 
     proto::RPCCommand out{};
     out.set_version(RPC_COMMAND_VERSION);
-    out.set_cookie(Identifier::Random()->str());
+    out.set_cookie(cookies_.Next());
     out.set_type(proto::RPCCOMMAND_LISTUNITDEFINITIONS);
     out.set_session(instance);
-    const auto valid = proto::Validate(out, VERBOSE);
+    const auto valid = validate(out);
 
     OT_ASSERT(valid)
 
+    set_page(out.cookie(), page);
     const auto sent = send_message(socket, out);
 
     OT_ASSERT(sent)
@@ -2043,10 +2813,7 @@ void CLI::list_unit_definitions(
 void CLI::list_unit_definitions_response(const proto::RPCResponse& in)
 {
     print_basic_info(in);
-
-    for (const auto& id : in.identifier()) {
-        LogOutput("   Unit definition: ")(id).Flush();
-    }
+    print_page(in, "   Unit definition: ");
 }
 
 void CLI::move_funds(const std::string& in, const zmq::socket::Dealer& socket)
@@ -2055,7 +2822,7 @@ void CLI::move_funds(const std::string& in, const zmq::socket::Dealer& socket)
     std::string sourceAccountID{""};
     std::string destinationAccountID{""};
     std::string memo{""};
-    int amount{-1};
+    std::int64_t amount{-1};
 
     po::options_description options("Options");
     options.add_options()("instance", po::value<int>(&instance), "<number>");
@@ -2066,7 +2833,8 @@ void CLI::move_funds(const std::string& in, const zmq::socket::Dealer& socket)
         po::value<std::string>(&destinationAccountID),
         "<string>");
     options.add_options()("memo", po::value<std::string>(&memo), "<string>");
-    options.add_options()("amount", po::value<int>(&amount), "<number>");
+    options.add_options()(
+        "amount", po::value<std::int64_t>(&amount), "<number>");
     auto hasOptions = parse_command(in, options);
 
     if (!hasOptions) {
@@ -2101,7 +2869,7 @@ void CLI::move_funds(const std::string& in, const zmq::socket::Dealer& socket)
 
     proto::RPCCommand out{};
     out.set_version(RPC_COMMAND_VERSION);
-    out.set_cookie(Identifier::Random()->str());
+    out.set_cookie(cookies_.Next());
     out.set_type(proto::RPCCOMMAND_MOVEFUNDS);
     out.set_session(instance);
 
@@ -2111,9 +2879,9 @@ void CLI::move_funds(const std::string& in, const zmq::socket::Dealer& socket)
     movefunds.set_sourceaccount(sourceAccountID);
     movefunds.set_destinationaccount(destinationAccountID);
     if (!memo.empty()) { movefunds.set_memo(memo); }
-    movefunds.set_amount(static_cast<unsigned int>(amount));
+    movefunds.set_amount(amount);
 
-    const auto valid = proto::Validate(out, VERBOSE);
+    const auto valid = validate(out);
 
     OT_ASSERT(valid)
 
@@ -2127,13 +2895,37 @@ void CLI::move_funds_response(const proto::RPCResponse& in)
     print_basic_info(in);
 }
 
+proto::RPCCommand CLI::new_command(
+    const proto::RPCCommandType type,
+    const int instance)
+{
+    proto::RPCCommand output{};
+    output.set_version(RPC_COMMAND_VERSION);
+    output.set_cookie(cookies_.Next());
+    output.set_type(type);
+    output.set_session(instance);
+
+    return output;
+}
+
 bool CLI::parse_command(
     const std::string& input,
     po::options_description& options)
+{
+    return parse_command(input, options, {});
+}
+
+bool CLI::parse_command(
+    const std::string& input,
+    po::options_description& options,
+    const po::positional_options_description& positional)
 {
     po::variables_map variables;
     po::store(
-        po::command_line_parser(po::split_unix(input)).options(options).run(),
+        po::command_line_parser(po::split_unix(input))
+            .options(options)
+            .positional(positional)
+            .run(),
         variables);
     po::notify(variables);
 
@@ -2142,182 +2934,1611 @@ bool CLI::parse_command(
     return true;
 }
 
-void CLI::print_basic_info(const proto::RPCPush& in)
+// Usage: payments --file <csv> [--journal <path>] [--window N] [--rate N]
+//
+// Each row is instance,contact,sourceaccount,destinationaccount,amount,memo.
+// Rows without a destination account are sent as cheques, the others as
+// transfers. Every row is journaled before it is sent (see PaymentJournal)
+// and a rerun with the same journal skips rows which already went out, so an
+// interrupted run can simply be started again. Rows whose task failed or
+// whose outcome is unknown are listed and make the rerun exit non-zero.
+void CLI::payments(const std::string& in, const zmq::socket::Dealer& socket)
 {
-    LogOutput(" * Received RPC push notification for ")(in.id()).Flush();
-}
+    struct Row {
+        std::uint64_t line_{0};
+        int instance_{-1};
+        std::string contact_{};
+        std::string source_{};
+        std::string destination_{};
+        std::int64_t amount_{0};
+        std::string memo_{};
+        std::uint32_t checksum_{0};
+    };
+    struct State {
+        std::mutex lock_{};
+        std::map<std::string, std::size_t> status_{};
+        std::size_t succeeded_{0};
+        std::size_t failed_{0};
+        // Rows answered with RETRY during the current pass
+        std::vector<const Row*> retry_{};
+    };
 
-void CLI::print_basic_info(const proto::RPCResponse& in)
-{
-    LogOutput(" * Received RPC reply type: ")(get_command_name(in.type()))
-        .Flush();
+    std::string file{};
+    std::string journalPath{};
+    std::size_t window{FANOUT_WINDOW};
+    double rate{0};
 
-    for (auto status : in.status()) {
-        LogOutput("   Status: ")(get_status_name(status.code())).Flush();
+    po::options_description options("Options");
+    options.add_options()("file", po::value<std::string>(&file), "<csv>");
+    options.add_options()(
+        "journal",
+        po::value<std::string>(&journalPath),
+        "<path> Defaults to the csv path with .journal appended");
+    options.add_options()(
+        "window", po::value<std::size_t>(&window), "<number>");
+    options.add_options()(
+        "rate", po::value<double>(&rate), "<payments per second>");
+    auto hasOptions = parse_command(in, options);
 
-        if (proto::RPCRESPONSE_QUEUED == status.code() &&
-            static_cast<int>(status.index()) < in.task_size()) {
-            LogOutput("   Task ID: ")(
-                in.task(static_cast<int>(status.index())).id())
-                .Flush();
-        }
+    if (!hasOptions) {
+        print_options_description(options);
+        return;
     }
-}
 
-void CLI::print_options_description(po::options_description& options)
-{
-    std::stringstream str;
+    if (file.empty()) {
+        LogOutput(__FUNCTION__)(": Missing file option").Flush();
 
-    for (auto option : options.options()) {
-        str << option->format_name() << " " << option->description() << " ";
+        return;
     }
 
-    LogOutput(str.str()).Flush();
-}
+    if (journalPath.empty()) { journalPath = file + ".journal"; }
 
-void CLI::process_push(zmq::Message& in)
-{
-    const auto& frame = in.Body_at(1);
-    const auto response = proto::Factory<proto::RPCPush>(frame);
+    std::ifstream csv(file);
 
-    if (false == proto::Validate(response, VERBOSE)) {
-        LogOutput(__FUNCTION__)(": Invalid RPCPush.").Flush();
+    if (false == csv.good()) {
+        LogOutput(__FUNCTION__)(": Unable to read ")(file).Flush();
 
         return;
     }
 
-    const auto& instanceFrame = in.Body_at(2);
-    int instance = -1;
-    OTPassword::safe_memcpy(
-        &instance,
-        sizeof(instance),
-        instanceFrame.data(),
-        static_cast<std::uint32_t>(instanceFrame.size()));
+    std::vector<Row> rows{};
+    std::string line{};
+    std::uint64_t number{0};
 
-    try {
-        auto& handler = *push_handlers_.at(response.type());
-        handler(response, instance);
-    } catch (...) {
-        LogOutput(__FUNCTION__)(": Unhandled response type: ")(response.type())
-            .Flush();
-    }
-}
+    while (std::getline(csv, line)) {
+        ++number;
+        ::trim(line);
 
-void CLI::process_reply(zmq::Message& in)
-{
-    const auto& frame = in.Body_at(0);
-    const auto response = proto::Factory<proto::RPCResponse>(frame);
+        if (line.empty() || ('#' == line[0])) { continue; }
 
-    if (false == proto::Validate(response, VERBOSE)) {
-        LogOutput(__FUNCTION__)(": Invalid RPCResponse.").Flush();
+        std::vector<std::string> fields{};
 
-        return;
-    }
+        try {
+            boost::tokenizer<boost::escaped_list_separator<char>> tokens(line);
+            fields.assign(tokens.begin(), tokens.end());
+        } catch (const std::exception&) {
+        }
 
-    try {
-        auto& handler = *response_handlers_.at(response.type());
-        handler(response);
-    } catch (...) {
-        LogOutput(__FUNCTION__)(": Unhandled response type: ")(response.type())
-            .Flush();
-    }
-}
+        for (auto& field : fields) { ::trim(field); }
 
-void CLI::register_nym(const std::string& in, const zmq::socket::Dealer& socket)
-{
-    int instance{-1};
-    std::string nymID{""};
-    std::string serverID{""};
+        if ((1 == number) && (false == fields.empty()) &&
+            ("instance" == fields.front())) {
+            continue;
+        }
 
-    po::options_description options("Options");
-    options.add_options()("instance", po::value<int>(&instance), "<number>");
-    options.add_options()("owner", po::value<std::string>(&nymID), "<string>");
-    options.add_options()(
-        "server", po::value<std::string>(&serverID), "<string>");
-    auto hasOptions = parse_command(in, options);
+        Row row{};
+        row.line_ = number;
+        row.checksum_ = crc32(line.data(), line.size());
 
-    if (!hasOptions) {
-        print_options_description(options);
-        return;
-    }
+        try {
+            if ((5 > fields.size()) || (6 < fields.size())) {
+                throw std::invalid_argument("wrong number of fields");
+            }
 
-    if (-1 == instance) {
-        LogOutput(__FUNCTION__)(": Missing instance option").Flush();
+            std::size_t used{0};
+            row.instance_ = std::stoi(fields.at(0));
+            row.contact_ = fields.at(1);
+            row.source_ = fields.at(2);
+            row.destination_ = fields.at(3);
+            row.amount_ = std::stoll(fields.at(4), &used);
 
-        return;
-    }
+            if (used != fields.at(4).size()) {
+                throw std::invalid_argument("invalid amount");
+            }
 
-    if (nymID.empty()) {
-        LogOutput(__FUNCTION__)(": Missing nym id option").Flush();
+            if (6 == fields.size()) { row.memo_ = fields.at(5); }
+        } catch (const std::exception& e) {
+            LogOutput(__FUNCTION__)(": ")(file)(":")(number)(": ")(e.what())
+                .Flush();
 
-        return;
-    }
+            return;
+        }
 
-    if (serverID.empty()) {
-        LogOutput(__FUNCTION__)(": Missing server id option").Flush();
+        if ((0 > row.instance_) || row.contact_.empty() ||
+            row.source_.empty() || (0 >= row.amount_)) {
+            LogOutput(__FUNCTION__)(": ")(file)(":")(number)(
+                ": Instance, contact, source account and a positive amount are "
+                "required")
+                .Flush();
 
-        return;
+            return;
+        }
+
+        rows.emplace_back(std::move(row));
     }
 
-    proto::RPCCommand out{};
-    out.set_version(RPC_COMMAND_VERSION);
-    out.set_cookie(Identifier::Random()->str());
-    out.set_type(proto::RPCCOMMAND_REGISTERNYM);
-    out.set_session(instance);
-    out.add_associatenym(nymID);
-    out.set_owner(nymID);
-    out.set_notary(serverID);
-    const auto valid = proto::Validate(out, VERBOSE);
+    auto journal = std::make_shared<PaymentJournal>(journalPath);
 
-    OT_ASSERT(valid)
+    if (false == journal->good()) { return; }
 
-    const auto sent = send_message(socket, out);
+    const auto& entries = journal->Entries();
+    std::vector<const Row*> pending{};
+    std::size_t done{0};
+    std::size_t failed{0};
+    std::size_t unknown{0};
 
-    OT_ASSERT(sent)
-}
+    for (const auto& row : rows) {
+        const auto it = entries.find(row.line_);
 
-void CLI::register_nym_response(const proto::RPCResponse& in)
-{
-    print_basic_info(in);
-}
+        if (entries.end() == it) {
+            pending.emplace_back(&row);
 
-void CLI::remote_log(network::zeromq::Message& in)
-{
-    if (3 > in.Body().size()) { return; }
+            continue;
+        }
 
-    int level{-1};
-    const auto& levelFrame = in.Body_at(0);
-    const auto& messageFrame = in.Body_at(1);
-    const auto& id = in.Body_at(2);
-    OTPassword::safe_memcpy(
-        &level, sizeof(level), levelFrame.data(), levelFrame.size());
-    std::cout << "Remote log received:\n"
-              << "Level: " << level << "\n"
-              << "Thread ID: " << std::string(id) << "\n"
-              << "Message:\n"
-              << std::string(messageFrame) << std::endl;
-}
+        const auto& entry = it->second;
 
-int CLI::Run()
-{
-    std::string input{};
-    LogOutput("otctl shell mode activated").Flush();
+        if (entry.checksum_ != row.checksum_) {
+            LogOutput(__FUNCTION__)(": ")(file)(":")(row.line_)(
+                " differs from the row recorded in ")(journalPath)
+                .Flush();
 
-    while (true) {
-        std::cout << std::endl << "$ ";
-        std::getline(std::cin, input);
+            return;
+        }
 
-        if (input.empty()) { continue; }
+        const auto rejected =
+            entry.replied_ && (proto::RPCRESPONSE_SUCCESS != entry.status_) &&
+            (proto::RPCRESPONSE_QUEUED != entry.status_);
+
+        if (rejected) {
+            // otagent refused the command, so nothing was paid
+            pending.emplace_back(&row);
+        } else if (
+            entry.replied_ && (proto::RPCRESPONSE_SUCCESS == entry.status_)) {
+            ++done;
+        } else if (entry.finished_ && entry.success_) {
+            ++done;
+        } else if (entry.finished_) {
+            // The task may have failed after reaching the notary, so a
+            // resend could pay twice. Left for the operator.
+            ++failed;
+            LogOutput(__FUNCTION__)(": ")(file)(":")(row.line_)(
+                ": task failed, cookie ")(entry.cookie_)(", task ")(
+                entry.task_)
+                .Flush();
+        } else {
+            // Sent, but whether it was executed is unknown. Never resend.
+            ++unknown;
+            LogOutput(__FUNCTION__)(": ")(file)(":")(row.line_)(
+                ": outcome unknown, cookie ")(entry.cookie_)(
+                entry.task_.empty() ? std::string{} : ", task " + entry.task_)
+                .Flush();
+        }
+    }
 
-        if (input[0] == '#') continue;
+    LogOutput(__FUNCTION__)(": ")(rows.size())(" rows, ")(done)(
+        " already sent, ")(failed)(" failed, ")(unknown)(" unknown, ")(
+        pending.size())(" to send")
+        .Flush();
+    const auto start = std::chrono::steady_clock::now();
+    const std::chrono::seconds timeout{RPC_TIMEOUT_SECONDS};
+    auto state = std::make_shared<State>();
+    auto slots = std::make_shared<Window>(window, true);
+    // Tasks which are queued and not yet complete
+    auto tasks =
+        std::make_shared<Window>(std::max<std::size_t>(1, rows.size()));
+    std::size_t sent{0};
+    auto replied = true;
+
+    // RETRY is handled here rather than by send_message so that every cookie
+    // is journaled before it is sent. Rows refused with RETRY are sent again
+    // after each pass.
+    for (std::size_t attempt{0}; false == pending.empty(); ++attempt) {
+        const auto retry = (attempt < retries_);
+        const auto begin = std::chrono::steady_clock::now();
+        auto stopped = false;
+
+        for (std::size_t i{0}; i < pending.size(); ++i) {
+            const auto& row = *pending.at(i);
+
+            if (0 < rate) {
+                const std::chrono::duration<double> offset{i / rate};
+                std::this_thread::sleep_until(
+                    begin + std::chrono::duration_cast<
+                                std::chrono::steady_clock::duration>(offset));
+            }
 
-        auto first = input.substr(0, input.find(" "));
-        if ("quit" == first) { break; }
+            if (false == slots->Acquire(timeout)) {
+                LogOutput(__FUNCTION__)(": Timed out waiting for replies")
+                    .Flush();
+                stopped = true;
 
-        if (READ_HISTORY == first) {
-            std::string partial =
-                input.substr(READ_HISTORY.size(), std::string::npos);
-            ::trim(partial);
+                break;
+            }
+
+            auto command =
+                new_command(proto::RPCCOMMAND_SENDPAYMENT, row.instance_);
+            auto& sendpayment = *command.mutable_sendpayment();
+            sendpayment.set_version(SENDPAYMENT_VERSION);
+            sendpayment.set_type(
+                row.destination_.empty() ? proto::RPCPAYMENTTYPE_CHEQUE
+                                         : proto::RPCPAYMENTTYPE_TRANSFER);
+            sendpayment.set_contact(row.contact_);
+            sendpayment.set_sourceaccount(row.source_);
+
+            if (false == row.destination_.empty()) {
+                sendpayment.set_destinationaccount(row.destination_);
+            }
+
+            if (false == row.memo_.empty()) {
+                sendpayment.set_memo(row.memo_);
+            }
+
+            sendpayment.set_amount(row.amount_);
+
+            if (false == validate(command)) {
+                LogOutput(__FUNCTION__)(": ")(file)(":")(row.line_)(
+                    ": Invalid payment")
+                    .Flush();
+                slots->Release();
+
+                continue;
+            }
+
+            const auto durable =
+                journal->Intent(row.line_, row.checksum_, command.cookie());
+
+            if (false == durable) {
+                slots->Release();
+                stopped = true;
+
+                break;
+            }
+
+            const auto id = row.line_;
+            const auto* source = &row;
+            const auto sentOK = send_message(
+                socket,
+                command,
+                [=](const proto::RPCResponse& reply) {
+                    const auto code = (0 < reply.status_size())
+                                          ? reply.status(0).code()
+                                          : proto::RPCRESPONSE_NONE;
+                    const auto queued = (proto::RPCRESPONSE_QUEUED == code) &&
+                                        (0 < reply.task_size());
+                    journal->Reply(id, code, queued ? reply.task(0).id() : "");
+
+                    {
+                        Lock lock(state->lock_);
+
+                        if (retry && (proto::RPCRESPONSE_RETRY == code)) {
+                            state->retry_.emplace_back(source);
+                        } else {
+                            ++state->status_[get_status_name(code)];
+                        }
+                    }
+
+                    if (queued) { tasks->Acquire(std::chrono::seconds(0)); }
+
+                    slots->Release();
+                },
+                [=](const std::string&, const bool success) {
+                    journal->Result(id, success);
+
+                    {
+                        Lock lock(state->lock_);
+                        ++(success ? state->succeeded_ : state->failed_);
+                    }
+
+                    tasks->Release();
+                },
+                slots,
+                retries_);
+
+            if (false == sentOK) {
+                slots->Release();
+                stopped = true;
+
+                break;
+            }
+
+            if (0 == attempt) { ++sent; }
+        }
+
+        replied = slots->Wait(timeout);
+
+        if (stopped || (false == replied)) { break; }
+
+        {
+            Lock lock(state->lock_);
+            pending.swap(state->retry_);
+            state->retry_.clear();
+        }
+
+        if (false == pending.empty()) {
+            std::this_thread::sleep_for(retry_delay(attempt));
+        }
+    }
+
+    const auto finished = replied && tasks->Wait(timeout);
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+    Lock lock(state->lock_);
+    std::stringstream out{};
+    out << sent << " payments sent in " << elapsed.count() << " ms\n";
+
+    for (const auto& [status, count] : state->status_) {
+        out << "   " << status << ": " << count << "\n";
+    }
+
+    out << "   Tasks succeeded: " << state->succeeded_
+        << "  failed: " << state->failed_;
+
+    if (false == finished) {
+        out << "\n   Gave up waiting for "
+            << (replied ? "task results" : "replies")
+            << ". A rerun with the same journal lists them as unknown.";
+    }
+
+    LogOutput(out.str()).Flush();
+    const auto accepted = state->status_[get_status_name(
+                              proto::RPCRESPONSE_QUEUED)] +
+                          state->status_[get_status_name(
+                              proto::RPCRESPONSE_SUCCESS)];
+
+    if ((false == finished) || (0 < failed) || (0 < unknown) ||
+        (0 < state->failed_) || (accepted != sent)) {
+        exit_status_ = 1;
+    }
+}
+
+void CLI::print_basic_info(const proto::RPCPush& in)
+{
+    LogOutput(" * Received RPC push notification for ")(in.id()).Flush();
+}
+
+void CLI::print_basic_info(const proto::RPCResponse& in)
+{
+    LogOutput(" * Received RPC reply type: ")(get_command_name(in.type()))
+        .Flush();
+    LogOutput("   Cookie: ")(in.cookie()).Flush();
+
+    for (auto status : in.status()) {
+        LogOutput("   Status: ")(get_status_name(status.code())).Flush();
+
+        if (proto::RPCRESPONSE_QUEUED == status.code() &&
+            static_cast<int>(status.index()) < in.task_size()) {
+            LogOutput("   Task ID: ")(
+                in.task(static_cast<int>(status.index())).id())
+                .Flush();
+        }
+    }
+}
+
+// Maps per-item status entries back to the inputs of a batched command
+void CLI::print_items(const proto::RPCResponse& in)
+{
+    std::vector<std::string> items{};
+
+    {
+        Lock lock(context_lock_);
+        auto it = batches_.find(in.cookie());
+
+        if (batches_.end() == it) { return; }
+
+        items = std::move(it->second);
+        batches_.erase(it);
+    }
+
+    // Single item commands are already fully described by print_basic_info
+    if (2 > items.size()) { return; }
+
+    std::stringstream out{};
+
+    for (const auto& status : in.status()) {
+        const auto index = static_cast<std::size_t>(status.index());
+        out << "   [" << index << "] "
+            << ((index < items.size()) ? items.at(index) : std::string{"?"})
+            << ": " << get_status_name(status.code()) << "\n";
+    }
+
+    LogOutput(out.str()).Flush();
+}
+
+void CLI::print_options_description(po::options_description& options)
+{
+    std::stringstream str;
+
+    for (auto option : options.options()) {
+        str << option->format_name() << " " << option->description() << " ";
+    }
+
+    LogOutput(str.str()).Flush();
+}
+
+// The RPC interface returns every identifier in a single reply, so only the
+// requested range is rendered and it is emitted in pages rather than one log
+// line per identifier.
+void CLI::print_page(const proto::RPCResponse& in, const std::string& label)
+{
+    Page page{};
+
+    {
+        Lock lock(context_lock_);
+        auto it = pages_.find(in.cookie());
+
+        if (pages_.end() != it) {
+            page = it->second;
+            pages_.erase(it);
+        }
+    }
+
+    const auto total = static_cast<std::size_t>(in.identifier_size());
+    auto first = std::min(page.start_, total);
+
+    if (false == page.after_.empty()) {
+        first = total;
+
+        for (std::size_t i{0}; i < total; ++i) {
+            if (page.after_ == in.identifier(static_cast<int>(i))) {
+                first = i + 1;
+
+                break;
+            }
+        }
+
+        if (total == first) {
+            LogOutput("   Continuation identifier not found: ")(page.after_)
+                .Flush();
+        }
+    }
+
+    const auto last =
+        (0 == page.limit_) ? total : std::min(total, first + page.limit_);
+    const auto size = (0 == page.size_) ? std::size_t{LIST_PAGE_SIZE}
+                                        : page.size_;
+    std::string out{};
+
+    for (auto i = first; i < last; ++i) {
+        out += label;
+        out += in.identifier(static_cast<int>(i));
+        out += '\n';
+        const auto count = i + 1 - first;
+
+        if ((0 == count % size) || (last == i + 1)) {
+            out += "   -- ";
+            out += std::to_string(count);
+            out += " of ";
+            out += std::to_string(last - first);
+            LogOutput(out).Flush();
+            out.clear();
+        }
+    }
+
+    LogOutput("   Listed ")(last - first)(" of ")(total)(" (")(first)("-")(
+        last)(")")
+        .Flush();
+
+    if (last < total) {
+        LogOutput("   Continue with --after ")(
+            in.identifier(static_cast<int>(last - 1)))(" or --start ")(last)
+            .Flush();
+    }
+}
+
+void CLI::process_push(zmq::Message& in)
+{
+    if (tracer_) { tracer_->Mark(); }
+
+    const auto& frame = in.Body_at(1);
+    const auto& instanceFrame = in.Body_at(2);
+    int instance = -1;
+    OTPassword::safe_memcpy(
+        &instance,
+        sizeof(instance),
+        instanceFrame.data(),
+        static_cast<std::uint32_t>(instanceFrame.size()));
+
+    if (recorder_) {
+        recorder_->Write(
+            TrafficRecorder::Direction::Push,
+            frame.data(),
+            frame.size(),
+            instance);
+    }
+
+    const auto response = proto::Factory<proto::RPCPush>(frame);
+
+    if (false == proto::Validate(response, VERBOSE)) {
+        LogOutput(__FUNCTION__)(": Invalid RPCPush.").Flush();
+
+        return;
+    }
+
+    if (tracer_) { tracer_->Phase("decode", response.id()); }
+
+    try {
+        const auto handler = push_handlers_.at(response.type());
+        (this->*handler)(response, instance);
+    } catch (...) {
+        LogOutput(__FUNCTION__)(": Unhandled response type: ")(response.type())
+            .Flush();
+    }
+
+    if (tracer_) { tracer_->Phase("render", response.id()); }
+}
+
+void CLI::process_reply(zmq::Message& in)
+{
+    const auto received = Tracer::Clock::now();
+
+    if (tracer_) { tracer_->Mark(); }
+
+    const auto& frame = in.Body_at(0);
+
+    if (recorder_) {
+        recorder_->Write(
+            TrafficRecorder::Direction::Reply, frame.data(), frame.size());
+    }
+
+    const auto response = proto::Factory<proto::RPCResponse>(frame);
+
+    if (false == proto::Validate(response, VERBOSE)) {
+        LogOutput(__FUNCTION__)(": Invalid RPCResponse.").Flush();
+
+        return;
+    }
+
+    if (tracer_) {
+        tracer_->End("wait", response.cookie(), received);
+        tracer_->Phase("decode", response.cookie());
+
+        for (const auto& status : response.status()) {
+            const auto index = static_cast<int>(status.index());
+
+            if ((proto::RPCRESPONSE_QUEUED == status.code()) &&
+                (index < response.task_size())) {
+                tracer_->TaskQueued(
+                    response.cookie(), response.task(index).id());
+            }
+        }
+    }
+
+    std::shared_ptr<LoadGenerator> load{};
+
+    {
+        Lock lock(load_lock_);
+        load = load_;
+    }
+
+    if (load && load->Reply(response)) { return; }
+
+    const auto callback =
+        tracker_.Replied(response, log_correlator_.Position());
+
+    if (callback) {
+        callback(response);
+    } else {
+        dispatch(response);
+    }
+
+    if (tracer_) { tracer_->Phase("render", response.cookie()); }
+}
+
+// Usage: provision --manifest <path> [--window N] [--output <path>]
+//
+// Each manifest row is instance,name,server[,unitdefinition...]. For every
+// row a nym is created and registered on the server, then an account is
+// created for each unit definition. Each step is sent as soon as the one it
+// depends on has succeeded, including steps which complete as queued tasks,
+// and up to --window users are provisioned at the same time.
+void CLI::provision(const std::string& in, const zmq::socket::Dealer& socket)
+{
+    using Action = std::function<void()>;
+    using Next = std::function<void(const std::string&)>;
+
+    struct User {
+        std::uint64_t line_{0};
+        int instance_{-1};
+        std::string name_{};
+        std::string server_{};
+        std::vector<std::string> units_{};
+        std::string nym_{};
+        std::vector<std::string> accounts_{};
+        std::size_t remaining_{0};
+        std::string error_{};
+    };
+    struct State {
+        std::mutex lock_{};
+        std::condition_variable cv_{};
+        std::vector<User> users_{};
+        // Commands are only sent from the thread running provision
+        std::deque<Action> actions_{};
+        std::size_t active_{0};
+        std::size_t done_{0};
+        std::size_t failed_{0};
+
+        void post(Action action)
+        {
+            {
+                Lock lock(lock_);
+                actions_.emplace_back(std::move(action));
+            }
+
+            cv_.notify_all();
+        }
+
+        // The first error reported for a user is the one kept
+        void finish(const std::size_t index, const std::string& error)
+        {
+            {
+                Lock lock(lock_);
+                complete(users_.at(index), error);
+            }
+
+            cv_.notify_all();
+        }
+
+        void account(
+            const std::size_t index,
+            const std::string& id,
+            const std::string& error)
+        {
+            {
+                Lock lock(lock_);
+                auto& user = users_.at(index);
+
+                if (error.empty()) { user.accounts_.emplace_back(id); }
+
+                if (0 < --user.remaining_) {
+                    if (user.error_.empty()) { user.error_ = error; }
+
+                    return;
+                }
+
+                complete(user, error);
+            }
+
+            cv_.notify_all();
+        }
+
+    private:
+        void complete(User& user, const std::string& error)
+        {
+            if (user.error_.empty()) { user.error_ = error; }
+
+            if (false == user.error_.empty()) { ++failed_; }
+
+            --active_;
+            ++done_;
+        }
+    };
+
+    std::string manifest{};
+    std::string output{};
+    std::size_t window{FANOUT_WINDOW};
+
+    po::options_description options("Options");
+    options.add_options()(
+        "manifest", po::value<std::string>(&manifest), "<path>");
+    options.add_options()(
+        "window",
+        po::value<std::size_t>(&window),
+        "<number> Users provisioned at the same time");
+    options.add_options()(
+        "output",
+        po::value<std::string>(&output),
+        "<path> Write name,nym,accounts,error for every user");
+    auto hasOptions = parse_command(in, options);
+
+    if (!hasOptions) {
+        print_options_description(options);
+        return;
+    }
+
+    if (manifest.empty()) {
+        LogOutput(__FUNCTION__)(": Missing manifest option").Flush();
+
+        return;
+    }
+
+    std::ifstream file(manifest);
+
+    if (false == file.good()) {
+        LogOutput(__FUNCTION__)(": Unable to read ")(manifest).Flush();
+
+        return;
+    }
+
+    auto state = std::make_shared<State>();
+    std::string line{};
+    std::uint64_t number{0};
+
+    while (std::getline(file, line)) {
+        ++number;
+        ::trim(line);
+
+        if (line.empty() || ('#' == line[0])) { continue; }
+
+        std::vector<std::string> fields{};
+
+        try {
+            boost::tokenizer<boost::escaped_list_separator<char>> tokens(line);
+            fields.assign(tokens.begin(), tokens.end());
+        } catch (const std::exception&) {
+        }
+
+        for (auto& field : fields) { ::trim(field); }
+
+        if ((1 == number) && (false == fields.empty()) &&
+            ("instance" == fields.front())) {
+            continue;
+        }
+
+        User user{};
+        user.line_ = number;
+
+        try {
+            if (3 > fields.size()) {
+                throw std::invalid_argument("wrong number of fields");
+            }
+
+            user.instance_ = std::stoi(fields.at(0));
+        } catch (const std::exception& e) {
+            LogOutput(__FUNCTION__)(": ")(manifest)(":")(number)(": ")(
+                e.what())
+                .Flush();
+
+            return;
+        }
+
+        user.name_ = fields.at(1);
+        user.server_ = fields.at(2);
+
+        for (auto i = fields.begin() + 3; i != fields.end(); ++i) {
+            if (false == i->empty()) { user.units_.emplace_back(*i); }
+        }
+
+        if ((0 > user.instance_) || user.name_.empty() ||
+            user.server_.empty()) {
+            LogOutput(__FUNCTION__)(": ")(manifest)(":")(number)(
+                ": Instance, name and server are required")
+                .Flush();
+
+            return;
+        }
+
+        state->users_.emplace_back(std::move(user));
+    }
+
+    const auto status = [](const proto::RPCResponse& reply) {
+        return (0 < reply.status_size()) ? reply.status(0).code()
+                                         : proto::RPCRESPONSE_NONE;
+    };
+    // Sends a command and posts next once it has succeeded, either in the
+    // reply or when the task it queued completes
+    const auto step = [this, &socket, state, status](
+                          const proto::RPCCommand& command,
+                          const std::string& stage,
+                          Next next,
+                          Next fail) {
+        const auto valid = validate(command);
+
+        OT_ASSERT(valid)
+
+        auto id = std::make_shared<std::string>();
+        const auto sent = send_message(
+            socket,
+            command,
+            [=](const proto::RPCResponse& reply) {
+                const auto code = status(reply);
+
+                if (0 < reply.identifier_size()) { *id = reply.identifier(0); }
+
+                if (proto::RPCRESPONSE_SUCCESS == code) {
+                    state->post([next, id]() { next(*id); });
+                } else if (proto::RPCRESPONSE_QUEUED != code) {
+                    fail(stage + " " + get_status_name(code));
+                }
+            },
+            [=](const std::string&, const bool success) {
+                if (success) {
+                    state->post([next, id]() { next(*id); });
+                } else {
+                    fail(stage + " task failed");
+                }
+            });
+
+        if (false == sent) { fail(stage + " not sent"); }
+    };
+    const auto createAccounts = [this, state, step](const std::size_t i) {
+        const auto& user = state->users_.at(i);
+
+        if (user.units_.empty()) {
+            state->finish(i, "");
+
+            return;
+        }
+
+        {
+            Lock lock(state->lock_);
+            state->users_.at(i).remaining_ = user.units_.size();
+        }
+
+        for (const auto& unit : user.units_) {
+            auto command =
+                new_command(proto::RPCCOMMAND_CREATEACCOUNT, user.instance_);
+            command.set_owner(user.nym_);
+            command.set_notary(user.server_);
+            command.set_unit(unit);
+            step(
+                command,
+                "createaccount",
+                [state, i](const std::string& id) {
+                    state->account(i, id, "");
+                },
+                [state, i](const std::string& error) {
+                    state->account(i, "", error);
+                });
+        }
+    };
+    const auto registerNym = [this, state, step, createAccounts](
+                                 const std::size_t i) {
+        const auto& user = state->users_.at(i);
+        auto command =
+            new_command(proto::RPCCOMMAND_REGISTERNYM, user.instance_);
+        command.add_associatenym(user.nym_);
+        command.set_owner(user.nym_);
+        command.set_notary(user.server_);
+        step(
+            command,
+            "registernym",
+            [createAccounts, i](const std::string&) { createAccounts(i); },
+            [state, i](const std::string& error) { state->finish(i, error); });
+    };
+    const auto createNym = [this, state, step, registerNym](
+                               const std::size_t i) {
+        const auto& user = state->users_.at(i);
+        auto command = new_command(proto::RPCCOMMAND_CREATENYM, user.instance_);
+        auto& create = *command.mutable_createnym();
+        create.set_version(CREATE_NYM_VERSION);
+        create.set_type(proto::CITEMTYPE_INDIVIDUAL);
+        create.set_name(user.name_);
+        create.set_seedid("");
+        create.set_index(-1);
+        step(
+            command,
+            "createnym",
+            [state, registerNym, i](const std::string& nym) {
+                if (nym.empty()) {
+                    state->finish(i, "createnym returned no nym");
+
+                    return;
+                }
+
+                // Only this thread reads or writes nym_
+                state->users_.at(i).nym_ = nym;
+                registerNym(i);
+            },
+            [state, i](const std::string& error) { state->finish(i, error); });
+    };
+
+    const auto start = std::chrono::steady_clock::now();
+    const std::chrono::seconds timeout{RPC_TIMEOUT_SECONDS};
+    const auto total = state->users_.size();
+    window = std::max<std::size_t>(window, 1);
+    std::size_t next{0};
+    bool stalled{false};
+
+    while (true) {
+        std::unique_lock<std::mutex> lock(state->lock_);
+        const auto ready = state->cv_.wait_for(lock, timeout, [&]() {
+            return (false == state->actions_.empty()) ||
+                   ((next < total) && (state->active_ < window)) ||
+                   (total == state->done_);
+        });
+
+        if (false == ready) {
+            stalled = true;
+
+            break;
+        }
+
+        if (false == state->actions_.empty()) {
+            auto action = std::move(state->actions_.front());
+            state->actions_.pop_front();
+            lock.unlock();
+            action();
+
+            continue;
+        }
+
+        if (total == state->done_) { break; }
+
+        ++state->active_;
+        const auto index = next++;
+        lock.unlock();
+        createNym(index);
+    }
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+    Lock lock(state->lock_);
+    std::stringstream out{};
+    std::ofstream report{};
+
+    if (false == output.empty()) {
+        report.open(output, std::ios::out | std::ios::trunc);
+        report << "name,nym,accounts,error\n";
+    }
+
+    for (const auto& user : state->users_) {
+        if (report.is_open()) {
+            report << '"' << user.name_ << "\"," << user.nym_ << ","
+                   << boost::algorithm::join(user.accounts_, ";") << ",\""
+                   << user.error_ << "\"\n";
+        }
+
+        if (false == user.error_.empty()) {
+            out << manifest << ":" << user.line_ << " " << user.name_ << ": "
+                << user.error_ << "\n";
+        }
+    }
+
+    out << state->done_ - state->failed_ << " of " << total
+        << " users provisioned, " << state->failed_ << " failed in "
+        << elapsed.count() << " ms";
+
+    if (stalled) {
+        out << "\nTimed out with " << (total - state->done_)
+            << " users unfinished";
+    }
+
+    LogOutput(out.str()).Flush();
+
+    if (report.is_open() && (false == report.good())) {
+        LogOutput(__FUNCTION__)(": Unable to write ")(output).Flush();
+    }
+
+    if (stalled || (0 < state->failed_)) { exit_status_ = 1; }
+}
+
+// Usage: reconcile --instance N [--account <id>... | --file <path>]
+//                  [--window N] [--threads N]
+//
+// Requests the balance and the activity of every account, or of the listed
+// accounts, and reports each account whose balance differs from the sum of
+// its activity. Replies are summed on a worker pool while later requests are
+// still in flight.
+void CLI::reconcile(const std::string& in, const zmq::socket::Dealer& socket)
+{
+    struct Account {
+        std::string id_{};
+        std::int64_t balance_{0};
+        std::int64_t pending_{0};
+        std::int64_t activity_{0};
+        std::int64_t activityPending_{0};
+        std::size_t events_{0};
+        std::vector<std::string> suspects_{};
+        // Written by different workers, hence kept apart
+        std::string balanceStatus_{};
+        std::string activityStatus_{};
+        // Balance and activity both decrement this once they are processed
+        std::atomic<int> remaining_{2};
+        bool mismatch_{false};
+    };
+
+    int instance{-1};
+    std::vector<std::string> ids{};
+    std::string file{};
+    std::size_t window{FANOUT_WINDOW};
+    std::size_t threads{0};
+
+    po::options_description options("Options");
+    options.add_options()("instance", po::value<int>(&instance), "<number>");
+    options.add_options()(
+        "account",
+        po::value<std::vector<std::string>>(&ids)->multitoken(),
+        "<string>...");
+    options.add_options()("file", po::value<std::string>(&file), "<path>");
+    options.add_options()(
+        "window", po::value<std::size_t>(&window), "<number>");
+    options.add_options()(
+        "threads",
+        po::value<std::size_t>(&threads),
+        "<number> Worker threads, default one per core");
+    auto hasOptions = parse_command(in, options);
+
+    if (!hasOptions) {
+        print_options_description(options);
+        exit_status_ = 1;
+
+        return;
+    }
+
+    if (-1 == instance) {
+        LogOutput(__FUNCTION__)(": Missing instance option").Flush();
+        exit_status_ = 1;
+
+        return;
+    }
+
+    if ((false == file.empty()) && (false == read_items(file, ids))) {
+        LogOutput(__FUNCTION__)(": Unable to read ")(file).Flush();
+        exit_status_ = 1;
+
+        return;
+    }
+
+    if (ids.empty()) {
+        proto::RPCResponse accounts{};
+
+        if (false ==
+            request(
+                socket,
+                new_command(proto::RPCCOMMAND_LISTACCOUNTS, instance),
+                accounts)) {
+            LogOutput(__FUNCTION__)(": No reply to LISTACCOUNTS").Flush();
+            exit_status_ = 1;
+
+            return;
+        }
+
+        // NONE is how an empty list is reported
+        if ((0 < accounts.status_size()) &&
+            (proto::RPCRESPONSE_SUCCESS != accounts.status(0).code()) &&
+            (proto::RPCRESPONSE_NONE != accounts.status(0).code())) {
+            LogOutput(__FUNCTION__)(": LISTACCOUNTS failed: ")(
+                get_status_name(accounts.status(0).code()))
+                .Flush();
+            exit_status_ = 1;
+
+            return;
+        }
+
+        ids.assign(accounts.identifier().begin(), accounts.identifier().end());
+    }
+
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    // Every entry exists before the first request is sent, so workers never
+    // modify the container
+    auto accounts = std::make_shared<std::vector<Account>>(ids.size());
+
+    for (std::size_t i{0}; i < ids.size(); ++i) {
+        accounts->at(i).id_ = ids.at(i);
+    }
+
+    const auto finish = [](Account& account) {
+        if (1 != account.remaining_.fetch_sub(1)) { return; }
+
+        account.mismatch_ = account.balanceStatus_.empty() &&
+                            account.activityStatus_.empty() &&
+                            ((account.balance_ != account.activity_) ||
+                             (account.pending_ != account.activityPending_));
+    };
+    const auto status = [](const proto::RPCResponse& reply) {
+        return (0 < reply.status_size())
+                   ? get_status_name(reply.status(0).code())
+                   : std::string{"NONE"};
+    };
+    const auto start = std::chrono::steady_clock::now();
+    const std::chrono::seconds timeout{RPC_TIMEOUT_SECONDS};
+    auto pool = std::make_shared<WorkerPool>(threads);
+    auto slots = std::make_shared<Window>(window, true);
+    // Both handlers hold the accounts so that replies arriving after a
+    // timeout still have somewhere to go
+    const auto onBalance = [accounts, slots, finish, status](
+                               Account& account,
+                               const proto::RPCResponse& reply) {
+        if (0 == reply.balance_size()) {
+            account.balanceStatus_ = "balance " + status(reply);
+        } else {
+            account.balance_ = reply.balance(0).balance();
+            account.pending_ = reply.balance(0).pendingbalance();
+        }
+
+        finish(account);
+        slots->Release();
+    };
+    const auto onActivity = [accounts, slots, finish, status](
+                                Account& account,
+                                const proto::RPCResponse& reply) {
+        if ((0 < reply.status_size()) &&
+            (proto::RPCRESPONSE_SUCCESS != reply.status(0).code()) &&
+            (proto::RPCRESPONSE_NONE != reply.status(0).code())) {
+            account.activityStatus_ = "activity " + status(reply);
+        }
+
+        std::map<std::string, std::int64_t> latest{};
+
+        for (const auto& event : reply.accountevent()) {
+            account.activity_ += event.amount();
+            account.activityPending_ += event.pendingamount();
+            ++account.events_;
+            auto& time = latest[event.workflow()];
+            time = std::max<std::int64_t>(time, event.timestamp());
+
+            if (0 != event.pendingamount()) {
+                account.suspects_.emplace_back(event.workflow());
+            }
+        }
+
+        auto& suspects = account.suspects_;
+
+        // Without unsettled workflows the most recent ones are the likeliest
+        // not to be reflected in the balance yet
+        if (suspects.empty()) {
+            std::vector<std::pair<std::int64_t, std::string>> recent{};
+
+            for (const auto& [workflow, time] : latest) {
+                recent.emplace_back(time, workflow);
+            }
+
+            std::sort(recent.rbegin(), recent.rend());
+            recent.resize(
+                std::min<std::size_t>(recent.size(), RECONCILE_SUSPECTS));
+
+            for (const auto& item : recent) {
+                suspects.emplace_back(item.second);
+            }
+        } else {
+            std::sort(suspects.begin(), suspects.end());
+            suspects.erase(
+                std::unique(suspects.begin(), suspects.end()), suspects.end());
+        }
+
+        finish(account);
+        slots->Release();
+    };
+    bool complete{true};
+
+    for (std::size_t i{0}; i < accounts->size(); ++i) {
+        auto* account = &accounts->at(i);
+        auto balance =
+            new_command(proto::RPCCOMMAND_GETACCOUNTBALANCE, instance);
+        balance.add_identifier(account->id_);
+        auto activity =
+            new_command(proto::RPCCOMMAND_GETACCOUNTACTIVITY, instance);
+        activity.add_identifier(account->id_);
+
+        if (false == slots->Acquire(timeout)) {
+            complete = false;
+
+            break;
+        }
+
+        auto sent = send_message(
+            socket,
+            balance,
+            [=](const auto& reply) {
+                pool->Post([=]() { onBalance(*account, reply); });
+            },
+            {},
+            slots);
+
+        if (false == sent) {
+            account->balanceStatus_ = "balance not sent";
+            finish(*account);
+            slots->Release();
+        }
+
+        if (false == slots->Acquire(timeout)) {
+            complete = false;
+
+            break;
+        }
+
+        sent = send_message(
+            socket,
+            activity,
+            [=](const auto& reply) {
+                pool->Post([=]() { onActivity(*account, reply); });
+            },
+            {},
+            slots);
+
+        if (false == sent) {
+            account->activityStatus_ = "activity not sent";
+            finish(*account);
+            slots->Release();
+        }
+    }
+
+    if ((false == complete) || (false == slots->Wait(timeout))) {
+        LogOutput(__FUNCTION__)(": Timed out waiting for replies").Flush();
+        exit_status_ = 1;
+
+        return;
+    }
+
+    pool->Wait();
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+    std::size_t mismatched{0};
+    std::size_t failed{0};
+    std::size_t events{0};
+    std::stringstream out{};
+
+    for (const auto& account : *accounts) {
+        events += account.events_;
+
+        auto status = account.balanceStatus_;
+
+        if (false == account.activityStatus_.empty()) {
+            if (false == status.empty()) { status += ", "; }
+
+            status += account.activityStatus_;
+        }
+
+        if (false == status.empty()) {
+            ++failed;
+            out << account.id_ << "  " << status << "\n";
+
+            continue;
+        }
+
+        if (false == account.mismatch_) { continue; }
+
+        ++mismatched;
+        out << account.id_ << "\n"
+            << "   Balance: " << account.balance_
+            << "  Activity: " << account.activity_
+            << "  Difference: " << account.balance_ - account.activity_
+            << "\n"
+            << "   Pending: " << account.pending_
+            << "  Activity: " << account.activityPending_
+            << "  Difference: "
+            << account.pending_ - account.activityPending_ << "\n";
+
+        for (const auto& workflow : account.suspects_) {
+            out << "   Workflow: " << workflow << "\n";
+        }
+    }
+
+    out << accounts->size() << " accounts, " << events << " events, "
+        << mismatched << " mismatched, " << failed << " failed in "
+        << elapsed.count() << " ms";
+    LogOutput(out.str()).Flush();
+
+    if ((0 < mismatched) || (0 < failed)) { exit_status_ = 1; }
+}
+
+void CLI::register_nym(const std::string& in, const zmq::socket::Dealer& socket)
+{
+    int instance{-1};
+    std::string nymID{""};
+    std::string serverID{""};
+
+    po::options_description options("Options");
+    options.add_options()("instance", po::value<int>(&instance), "<number>");
+    options.add_options()("owner", po::value<std::string>(&nymID), "<string>");
+    options.add_options()(
+        "server", po::value<std::string>(&serverID), "<string>");
+    auto hasOptions = parse_command(in, options);
+
+    if (!hasOptions) {
+        print_options_description(options);
+        return;
+    }
+
+    if (-1 == instance) {
+        LogOutput(__FUNCTION__)(": Missing instance option").Flush();
+
+        return;
+    }
+
+    if (nymID.empty()) {
+        LogOutput(__FUNCTION__)(": Missing nym id option").Flush();
+
+        return;
+    }
+
+    if (serverID.empty()) {
+        LogOutput(__FUNCTION__)(": Missing server id option").Flush();
+
+        return;
+    }
+
+    proto::RPCCommand out{};
+    out.set_version(RPC_COMMAND_VERSION);
+    out.set_cookie(cookies_.Next());
+    out.set_type(proto::RPCCOMMAND_REGISTERNYM);
+    out.set_session(instance);
+    out.add_associatenym(nymID);
+    out.set_owner(nymID);
+    out.set_notary(serverID);
+    const auto valid = validate(out);
+
+    OT_ASSERT(valid)
+
+    const auto sent = send_message(socket, out);
+
+    OT_ASSERT(sent)
+}
+
+void CLI::register_nym_response(const proto::RPCResponse& in)
+{
+    print_basic_info(in);
+}
+
+void CLI::rekey(const std::string& from, const std::string& to)
+{
+    Lock lock(context_lock_);
+    const auto page = pages_.find(from);
+
+    if (pages_.end() != page) {
+        pages_[to] = page->second;
+        pages_.erase(page);
+        page_order_.push_back(to);
+    }
+
+    const auto batch = batches_.find(from);
+
+    if (batches_.end() != batch) {
+        batches_[to] = std::move(batch->second);
+        batches_.erase(batch);
+        batch_order_.push_back(to);
+    }
+}
+
+void CLI::remote_log(network::zeromq::Message& in)
+{
+    if (3 > in.Body().size()) { return; }
+
+    int level{-1};
+    const auto& levelFrame = in.Body_at(0);
+    const auto& messageFrame = in.Body_at(1);
+    const auto& id = in.Body_at(2);
+    OTPassword::safe_memcpy(
+        &level, sizeof(level), levelFrame.data(), levelFrame.size());
+
+    const auto message = std::string(messageFrame);
+    const auto thread = std::string(id);
+
+    if (log_archive_) { log_archive_->Write(level, message, thread); }
+
+    log_correlator_.Add(level, message, thread);
+    const auto outstanding = tracker_.Outstanding();
+    std::stringstream tags{};
+
+    for (std::size_t i{0}; i < outstanding.size(); ++i) {
+        if (4 == i) {
+            tags << " (+" << (outstanding.size() - i) << " more)";
+
+            break;
+        }
+
+        tags << " " << outstanding.at(i);
+    }
+
+    std::cout << "Remote log received:\n"
+              << "Level: " << level << "\n"
+              << "Thread ID: " << thread << "\n"
+              << "Outstanding:" << tags.str() << "\n"
+              << "Message:\n"
+              << message << std::endl;
+}
+
+bool CLI::read_items(
+    const std::string& path,
+    std::vector<std::string>& items)
+{
+    std::ifstream file(path);
+
+    if (false == file.good()) { return false; }
+
+    std::string line{};
+
+    while (std::getline(file, line)) {
+        ::trim(line);
+
+        if (line.empty() || ('#' == line[0])) { continue; }
+
+        items.emplace_back(line);
+    }
+
+    return true;
+}
+
+// Usage: replay [--file] <capture> [--speed <factor> | --max] [--window N]
+//               [--session <recorded>:<replayed> ...]
+void CLI::replay(const std::string& in, const zmq::socket::Dealer& socket)
+{
+    std::string file{};
+    double speed{1.0};
+    bool max{false};
+    std::size_t window{BENCH_WINDOW};
+    std::vector<std::string> sessions{};
+
+    po::options_description options("Options");
+    options.add_options()("file", po::value<std::string>(&file), "<path>");
+    options.add_options()(
+        "speed",
+        po::value<double>(&speed),
+        "<factor> Multiply the recorded send rate");
+    options.add_options()(
+        "max", po::bool_switch(&max), "Send as fast as the window allows");
+    options.add_options()(
+        "window", po::value<std::size_t>(&window), "<number>");
+    options.add_options()(
+        "session",
+        po::value<std::vector<std::string>>(&sessions)->multitoken(),
+        "<recorded>:<replayed>");
+    po::positional_options_description positional{};
+    positional.add("file", 1);
+    parse_command(in, options, positional);
+
+    if (file.empty() || (0 >= speed)) {
+        print_options_description(options);
+
+        return;
+    }
+
+    std::map<std::int32_t, std::int32_t> remap{};
+
+    for (const auto& session : sessions) {
+        const auto colon = session.find(':');
+
+        try {
+            remap[std::stoi(session.substr(0, colon))] =
+                std::stoi(session.substr(colon + 1));
+        } catch (...) {
+            LogOutput(__FUNCTION__)(": Invalid session mapping ")(session)
+                .Flush();
+
+            return;
+        }
+    }
+
+    std::vector<TrafficRecorder::Record> records{};
+
+    if (false == TrafficRecorder::Read(file, records)) { return; }
+
+    std::vector<proto::RPCCommand> commands{};
+    std::vector<std::chrono::nanoseconds> schedule{};
+    std::map<std::string, std::uint64_t> sent{};
+    Histogram latency{LoadGenerator::HighestLatency};
+    std::map<proto::RPCResponseCode, std::uint64_t> status{};
+    std::uint64_t first{0};
+    // Recorded timestamps are wall clock time and may step backwards, in
+    // which case the command is sent together with its predecessor
+    const auto elapsed = [](const std::uint64_t from, const std::uint64_t to) {
+        return (to > from) ? static_cast<std::int64_t>(to - from) : 0;
+    };
+
+    for (const auto& record : records) {
+        if (TrafficRecorder::Direction::Command == record.direction_) {
+            proto::RPCCommand command{};
+
+            if (false == command.ParseFromString(record.data_)) { continue; }
+
+            if (commands.empty()) { first = record.time_; }
+
+            sent.emplace(command.cookie(), record.time_);
+            const auto due = std::chrono::nanoseconds(static_cast<std::int64_t>(
+                static_cast<double>(elapsed(first, record.time_)) / speed));
+            schedule.emplace_back(
+                schedule.empty() ? due : std::max(due, schedule.back()));
+            const auto mapped = remap.find(command.session());
+
+            if (remap.end() != mapped) { command.set_session(mapped->second); }
+
+            command.set_cookie(cookies_.Next());
+            commands.emplace_back(std::move(command));
+        } else if (TrafficRecorder::Direction::Reply == record.direction_) {
+            proto::RPCResponse response{};
+
+            if (false == response.ParseFromString(record.data_)) { continue; }
+
+            const auto it = sent.find(response.cookie());
+
+            if (sent.end() == it) { continue; }
+
+            latency.Record(elapsed(it->second, record.time_));
+            ++status[(0 < response.status_size())
+                         ? response.status(0).code()
+                         : proto::RPCRESPONSE_NONE];
+            sent.erase(it);
+        }
+    }
+
+    if (commands.empty()) {
+        LogOutput(__FUNCTION__)(": ")(file)(" contains no commands").Flush();
+
+        return;
+    }
+
+    LoadGenerator::Pacing pacing{};
+
+    if (false == max) { pacing.schedule_ = std::move(schedule); }
+
+    const auto results = start_load(commands)->Run(
+        socket, commands.size(), max ? window : commands.size(), pacing);
+    stop_load();
+    std::stringstream out{};
+    out << "Replayed " << results.sent_ << " of " << commands.size()
+        << " commands, received " << results.received_ << " replies in "
+        << std::chrono::duration<double>(results.elapsed_).count() << " s\n"
+        << "Recorded:\n"
+        << summarize(latency, status) << "Replayed:\n"
+        << summarize(results.latency_, results.status_);
+    LogOutput(out.str()).Flush();
+}
+
+// Sends a command and blocks until its reply arrives
+bool CLI::request(
+    const zmq::socket::Dealer& socket,
+    const proto::RPCCommand& command,
+    proto::RPCResponse& reply)
+{
+    auto promise = std::make_shared<std::promise<proto::RPCResponse>>();
+    auto future = promise->get_future();
+    const auto valid = validate(command);
+
+    OT_ASSERT(valid)
+
+    const auto sent =
+        send_message(socket, command, [promise](const auto& response) {
+            promise->set_value(response);
+        });
+
+    if (false == sent) { return false; }
+
+    if (std::future_status::ready !=
+        future.wait_for(std::chrono::seconds(RPC_TIMEOUT_SECONDS))) {
+        return false;
+    }
+
+    reply = future.get();
+
+    return true;
+}
+
+// Exponential backoff with full jitter, so that commands which were refused
+// together do not return together
+std::chrono::milliseconds CLI::retry_delay(const std::size_t attempt)
+{
+    thread_local std::minstd_rand random{std::random_device{}()};
+    const auto ceiling = std::min<std::int64_t>(
+        RETRY_MAX_DELAY_MS,
+        std::int64_t{RETRY_BASE_DELAY_MS}
+            << std::min<std::size_t>(attempt, 16));
+
+    return std::chrono::milliseconds(
+        std::uniform_int_distribution<std::int64_t>(0, ceiling)(random));
+}
+
+int CLI::Run()
+{
+    std::string input{};
+    LogOutput("otctl shell mode activated").Flush();
+
+    while (true) {
+        std::cout << std::endl << "$ ";
+        std::getline(std::cin, input);
+
+        if (input.empty()) { continue; }
+
+        if (input[0] == '#') continue;
+
+        auto first = input.substr(0, input.find(" "));
+        if ("quit" == first) { break; }
+
+        if (READ_HISTORY == first) {
+            std::string partial =
+                input.substr(READ_HISTORY.size(), std::string::npos);
+            ::trim(partial);
             if (partial.size() == 0) {
                 std::cerr << READ_HISTORY << " requires a valid filename."
                           << std::endl;
@@ -2360,6 +4581,11 @@ int CLI::Run()
                 std::cerr << "Couldn't write history to file " << partial
                           << std::endl;
             continue;
+        } else if (LOGS == first) {
+            std::string partial = input.substr(LOGS.size(), std::string::npos);
+            ::trim(partial);
+            show_logs(partial);
+            continue;
         } else if (HISTORY == first) {
 
             std::string partial =
@@ -2408,26 +4634,358 @@ int CLI::Run()
     return 0;
 }
 
+int CLI::Run(const std::vector<std::string>& command)
+{
+    std::stringstream line{};
+
+    for (const auto& argument : command) {
+        if (std::string::npos == argument.find_first_of(" \t\"'\\")) {
+            line << argument << " ";
+        } else {
+            line << std::quoted(argument) << " ";
+        }
+    }
+
+    const auto& name = command.front();
+
+    if ((0 == composites_.count(name)) && (0 == commands_.count(name))) {
+        std::cerr << "ERROR: unknown subcommand " << name << std::endl;
+
+        return 1;
+    }
+
+    auto input = line.str();
+    ::trim(input);
+    execute(name, input);
+
+    return exit_status_;
+}
+
+void CLI::dispatch(const proto::RPCResponse& response)
+{
+    try {
+        const auto handler = response_handlers_.at(response.type());
+        (this->*handler)(response);
+    } catch (...) {
+        LogOutput(__FUNCTION__)(": Unhandled response type: ")(response.type())
+            .Flush();
+    }
+}
+
 void CLI::execute(std::string cmd, std::string arguments)
 {
     try {
         using namespace std::chrono_literals;
+        const auto composite = composites_.find(cmd);
+
+        if (tracer_) { tracer_->Mark(); }
+
+        if (composites_.end() != composite) {
+            (this->*composite->second)(arguments, socket_);
+            std::cerr << std::endl;
+
+            return;
+        }
+
         const auto command = commands_.at(cmd);
-        const auto& processor = *processors_.at(command);
-        processor(arguments, socket_);
+        const auto processor = processors_.at(command);
+        (this->*processor)(arguments, socket_);
         std::cerr << std::endl;           // flush the stream
         std::this_thread::sleep_for(1s);  // wait for process output/cerr
     } catch (po::error& err) {
         LogOutput("Error processing command: ")(err.what()).Flush();
+        exit_status_ = 1;
     } catch (...) {
         LogOutput("Unknown command").Flush();
+        exit_status_ = 1;
+    }
+}
+
+// Usage: fleet [--timeout <seconds>] -- <command> <options>
+//
+// Sends the commands produced by a command line to every otagent listed by
+// --fleet at the same time and merges the replies. The --endpoint otagent is
+// only included if the fleet file lists it as well. Identifiers are listed
+// with the endpoints which lack them, balances and sessions per endpoint, and
+// any other reply through its usual handler.
+void CLI::fleet(const std::string& in, const zmq::socket::Dealer&)
+{
+    struct Result {
+        std::chrono::steady_clock::time_point sent_{};
+        std::chrono::nanoseconds latency_{0};
+        std::size_t replied_{0};
+        std::size_t unsent_{0};
+        proto::RPCResponseCode status_{proto::RPCRESPONSE_NONE};
+        std::vector<proto::RPCResponse> replies_{};
+    };
+    struct State {
+        std::mutex lock_{};
+        std::map<std::string, Result> results_{};
+    };
+
+    const auto separator = in.find(" -- ");
+
+    if (std::string::npos == separator) {
+        LogOutput(__FUNCTION__)(
+            ": Usage: fleet [--timeout <seconds>] -- <command> <options>")
+            .Flush();
+        exit_status_ = 1;
+
+        return;
+    }
+
+    std::int64_t seconds{RPC_TIMEOUT_SECONDS};
+
+    po::options_description options("Options");
+    options.add_options()(
+        "timeout", po::value<std::int64_t>(&seconds), "<seconds>");
+    parse_command(in.substr(0, separator), options);
+
+    if (fleet_.empty()) {
+        LogOutput(__FUNCTION__)(": No endpoints. Start otctl with --fleet")
+            .Flush();
+        exit_status_ = 1;
+
+        return;
+    }
+
+    std::vector<proto::RPCCommand> commands{};
+
+    if (false == capture(in.substr(separator + 4), commands)) {
+        exit_status_ = 1;
+
+        return;
+    }
+
+    const auto state = std::make_shared<State>();
+    auto slots = std::make_shared<Window>(fleet_.size() * commands.size());
+    const std::chrono::seconds timeout{seconds};
+
+    for (const auto& [endpoint, peer] : fleet_) {
+        state->results_[endpoint].sent_ = std::chrono::steady_clock::now();
+    }
+
+    // Every endpoint gets its first command before any gets its second
+    for (const auto& command : commands) {
+        for (const auto& [endpoint, peer] : fleet_) {
+            const auto name = endpoint;
+            auto copy = command;
+            copy.set_cookie(cookies_.Next());
+            slots->Acquire(timeout);
+            const auto sent = send_message(
+                peer, copy, [=](const proto::RPCResponse& reply) {
+                    Lock lock(state->lock_);
+                    auto& result = state->results_[name];
+                    result.latency_ =
+                        std::chrono::steady_clock::now() - result.sent_;
+                    ++result.replied_;
+
+                    for (const auto& status : reply.status()) {
+                        const auto code = status.code();
+
+                        if ((proto::RPCRESPONSE_NONE == result.status_) ||
+                            ((proto::RPCRESPONSE_SUCCESS != code) &&
+                             (proto::RPCRESPONSE_QUEUED != code))) {
+                            result.status_ = code;
+                        }
+                    }
+
+                    result.replies_.emplace_back(reply);
+                    lock.unlock();
+                    slots->Release();
+                });
+
+            if (false == sent) {
+                Lock lock(state->lock_);
+                ++state->results_[name].unsent_;
+                lock.unlock();
+                slots->Release();
+            }
+        }
+    }
+
+    if (false == slots->Wait(timeout)) {
+        LogOutput(__FUNCTION__)(": Timed out waiting for replies").Flush();
+    }
+
+    Lock lock(state->lock_);
+    const auto total = state->results_.size();
+    std::map<std::string, std::set<std::string>> identifiers{};
+    std::stringstream out{};
+    std::stringstream balances{};
+    std::stringstream sessions{};
+    std::vector<std::pair<std::string, proto::RPCResponse>> other{};
+    out << std::left << std::setw(48) << "Endpoint" << std::right
+        << std::setw(14) << "Latency (ms)" << std::setw(10) << "Replies"
+        << "  Status\n";
+
+    for (const auto& [endpoint, result] : state->results_) {
+        const auto complete = (result.replied_ == commands.size());
+        auto status = get_status_name(result.status_);
+
+        if (0 < result.unsent_) {
+            status = std::to_string(result.unsent_) + " NOT SENT";
+        } else if (false == complete) {
+            status = "TIMED OUT";
+        }
+
+        out << std::left << std::setw(48) << endpoint << std::right
+            << std::setw(14);
+
+        if (complete) {
+            out << std::fixed << std::setprecision(3)
+                << std::chrono::duration<double, std::milli>(result.latency_)
+                       .count();
+        } else {
+            out << "-";
+        }
+
+        out << std::setw(10)
+            << (std::to_string(result.replied_) + "/" +
+                std::to_string(commands.size()))
+            << "  " << status << "\n";
+
+        if ((false == complete) ||
+            ((proto::RPCRESPONSE_SUCCESS != result.status_) &&
+             (proto::RPCRESPONSE_QUEUED != result.status_))) {
+            exit_status_ = 1;
+        }
+
+        for (const auto& reply : result.replies_) {
+            for (const auto& id : reply.identifier()) {
+                identifiers[id].emplace(endpoint);
+            }
+
+            for (const auto& balance : reply.balance()) {
+                balances << std::left << std::setw(48) << balance.id()
+                         << std::right << std::setw(20) << balance.balance()
+                         << std::setw(20) << balance.pendingbalance() << "  "
+                         << endpoint << "\n";
+            }
+
+            for (const auto& session : reply.sessions()) {
+                sessions << std::left << std::setw(48) << endpoint
+                         << std::right << std::setw(10) << session.instance()
+                         << "\n";
+            }
+
+            if ((0 == reply.identifier_size()) &&
+                (0 == reply.balance_size()) && (0 == reply.sessions_size())) {
+                other.emplace_back(endpoint, reply);
+            }
+        }
+    }
+
+    if (false == identifiers.empty()) {
+        out << "\n" << std::left << std::setw(48) << "Identifier" << std::right
+            << std::setw(10) << "Present" << "  Missing from\n";
+
+        for (const auto& [id, present] : identifiers) {
+            out << std::left << std::setw(48) << id << std::right
+                << std::setw(10)
+                << (std::to_string(present.size()) + "/" +
+                    std::to_string(total));
+
+            for (const auto& item : state->results_) {
+                if (0 == present.count(item.first)) {
+                    out << "  " << item.first;
+                }
+            }
+
+            out << "\n";
+        }
+    }
+
+    if (false == balances.str().empty()) {
+        out << "\n" << std::left << std::setw(48) << "Account ID" << std::right
+            << std::setw(20) << "Balance" << std::setw(20) << "Pending"
+            << "  Endpoint\n"
+            << balances.str();
+    }
+
+    if (false == sessions.str().empty()) {
+        out << "\n" << std::left << std::setw(48) << "Endpoint" << std::right
+            << std::setw(10) << "Instance" << "\n"
+            << sessions.str();
+    }
+
+    LogOutput(out.str()).Flush();
+    lock.unlock();
+
+    for (const auto& [endpoint, reply] : other) {
+        LogOutput("Endpoint: ")(endpoint).Flush();
+        dispatch(reply);
     }
 }
 
 bool CLI::send_message(
     const zmq::socket::Dealer& socket,
-    const proto::RPCCommand command)
+    const proto::RPCCommand command,
+    RequestTracker::ReplyCallback callback,
+    RequestTracker::TaskCallback task,
+    std::shared_ptr<Window> window,
+    const std::size_t attempt)
 {
+    {
+        Lock lock(capture_lock_);
+
+        if ((nullptr != capture_) &&
+            (std::this_thread::get_id() == capturing_)) {
+            capture_->emplace_back(command);
+
+            return true;
+        }
+    }
+
+    if (window || (0 < retries_)) {
+        const auto sent = std::chrono::steady_clock::now();
+        callback = [=, &socket](const proto::RPCResponse& reply) {
+            const auto retry =
+                (0 < reply.status_size()) &&
+                (proto::RPCRESPONSE_RETRY == reply.status(0).code());
+
+            if (window) {
+                window->Feedback(
+                    std::chrono::steady_clock::now() - sent, retry);
+            }
+
+            if ((false == retry) || (attempt >= retries_)) {
+                if (callback) {
+                    callback(reply);
+                } else {
+                    dispatch(reply);
+                }
+
+                return;
+            }
+
+            auto next = command;
+            next.set_cookie(cookies_.Next());
+            scheduler_.At(
+                std::chrono::steady_clock::now() + retry_delay(attempt),
+                [=, &socket]() {
+                    // Page and batch state follow the command to its new
+                    // cookie
+                    rekey(command.cookie(), next.cookie());
+                    const auto resent = send_message(
+                        socket, next, callback, task, window, attempt + 1);
+
+                    // The caller still expects an answer
+                    if (false == resent) {
+                        rekey(next.cookie(), command.cookie());
+
+                        if (callback) {
+                            callback(reply);
+                        } else {
+                            dispatch(reply);
+                        }
+                    }
+                });
+        };
+    }
+
+    if (tracer_) { tracer_->Mark(); }
+
     auto message = zmq::Message::Factory();
     message->AddFrame();
     message->AddFrame(command);
@@ -2435,6 +4993,22 @@ bool CLI::send_message(
     OT_ASSERT(0 == message->Header().size())
     OT_ASSERT(1 == message->Body().size())
 
+    if (tracer_) { tracer_->Phase("serialize", command.cookie()); }
+
+    if (recorder_) {
+        const auto bytes = command.SerializeAsString();
+        recorder_->Write(
+            TrafficRecorder::Direction::Command, bytes.data(), bytes.size());
+    }
+
+    tracker_.Sent(
+        command,
+        log_correlator_.Position(),
+        std::move(callback),
+        std::move(task));
+
+    if (tracer_) { tracer_->Begin("wait", command.cookie()); }
+
     return socket.Send(message);
 }
 
@@ -2446,7 +5020,7 @@ void CLI::send_cheque(const std::string& in, const zmq::socket::Dealer& socket)
     std::string contactID{""};
     std::string sourceAccountID{""};
     std::string memo{""};
-    int amount{-1};
+    std::int64_t amount{-1};
 
     po::options_description options("Options");
     options.add_options()("instance", po::value<int>(&instance), "<number>");
@@ -2455,7 +5029,8 @@ void CLI::send_cheque(const std::string& in, const zmq::socket::Dealer& socket)
     options.add_options()(
         "sourceaccount", po::value<std::string>(&sourceAccountID), "<string>");
     options.add_options()("memo", po::value<std::string>(&memo), "<string>");
-    options.add_options()("amount", po::value<int>(&amount), "<number>");
+    options.add_options()(
+        "amount", po::value<std::int64_t>(&amount), "<number>");
     auto hasOptions = parse_command(in, options);
 
     if (!hasOptions) {
@@ -2489,7 +5064,7 @@ void CLI::send_cheque(const std::string& in, const zmq::socket::Dealer& socket)
 
     proto::RPCCommand out{};
     out.set_version(RPC_COMMAND_VERSION);
-    out.set_cookie(Identifier::Random()->str());
+    out.set_cookie(cookies_.Next());
     out.set_type(proto::RPCCOMMAND_SENDPAYMENT);
     out.set_session(instance);
 
@@ -2499,9 +5074,9 @@ void CLI::send_cheque(const std::string& in, const zmq::socket::Dealer& socket)
     sendpayment.set_contact(contactID);
     sendpayment.set_sourceaccount(sourceAccountID);
     if (!memo.empty()) { sendpayment.set_memo(memo); }
-    sendpayment.set_amount(static_cast<unsigned int>(amount));
+    sendpayment.set_amount(amount);
 
-    const auto valid = proto::Validate(out, VERBOSE);
+    const auto valid = validate(out);
 
     OT_ASSERT(valid)
 
@@ -2525,9 +5100,26 @@ void CLI::send_payment_response(const proto::RPCResponse& in)
     print_basic_info(in);
 }
 
+void CLI::set_batch(const std::string& cookie, std::vector<std::string> items)
+{
+    Lock lock(context_lock_);
+    batches_[cookie] = std::move(items);
+    batch_order_.push_back(cookie);
+
+    while (PENDING_CONTEXTS < batch_order_.size()) {
+        batches_.erase(batch_order_.front());
+        batch_order_.pop_front();
+    }
+}
+
 void CLI::set_keys(const po::variables_map& cli, zmq::socket::Dealer& socket)
 {
-    std::stringstream json(get_json(cli));
+    set_keys(get_json(cli), socket);
+}
+
+void CLI::set_keys(const std::string& keys, zmq::socket::Dealer& socket)
+{
+    std::stringstream json(keys);
     Json::Value root;
     json >> root;
     const auto main = root["otagent"];
@@ -2537,10 +5129,380 @@ void CLI::set_keys(const po::variables_map& cli, zmq::socket::Dealer& socket)
     socket.SetKeysZ85(serverKey, clientPrivateKey, clientPublicKey);
 }
 
+void CLI::set_page(const std::string& cookie, const Page& page)
+{
+    Lock lock(context_lock_);
+    pages_[cookie] = page;
+    page_order_.push_back(cookie);
+
+    // Commands which never receive a reply would otherwise keep their entry
+    while (PENDING_CONTEXTS < page_order_.size()) {
+        pages_.erase(page_order_.front());
+        page_order_.pop_front();
+    }
+}
+
+void CLI::show_logs(const std::string& id) const
+{
+    if (id.empty()) {
+        for (const auto& request : tracker_.Recent()) {
+            std::cout << request.cookie_ << " "
+                      << get_command_name(request.type_)
+                      << (request.replied_ ? "" : " (awaiting reply)");
+
+            for (const auto& task : request.tasks_) {
+                std::cout << "\n    Task: " << task;
+            }
+
+            std::cout << "\n";
+        }
+
+        std::cout << std::endl;
+
+        return;
+    }
+
+    std::vector<RequestTracker::Span> spans{};
+    std::vector<std::string> ids{};
+
+    // Unknown or expired identifiers are still matched against message text
+    if (false == tracker_.Spans(id, spans, ids)) { ids.emplace_back(id); }
+
+    for (const auto& entry : log_correlator_.Excerpt(spans, ids)) {
+        const auto time =
+            std::chrono::system_clock::to_time_t(entry.received_);
+        std::cout << "[" << entry.position_ << "] "
+                  << std::put_time(std::localtime(&time), "%F %T") << " level "
+                  << entry.level_ << " thread " << entry.thread_ << ":\n"
+                  << entry.message_ << "\n";
+    }
+
+    std::cout << std::endl;
+}
+
+// Replies to the generator's commands bypass the tracker until stop_load()
+std::shared_ptr<LoadGenerator> CLI::start_load(
+    const std::vector<proto::RPCCommand>& commands)
+{
+    auto load =
+        std::make_shared<LoadGenerator>(cookies_, commands, recorder_.get());
+    Lock lock(load_lock_);
+    load_ = load;
+
+    return load;
+}
+
+void CLI::stop_load()
+{
+    Lock lock(load_lock_);
+    load_.reset();
+}
+
+std::string CLI::summarize(
+    const Histogram& latency,
+    const std::map<proto::RPCResponseCode, std::uint64_t>& status)
+{
+    const auto percentile = [&](const double p) {
+        return latency.ValueAt(p) / 1000;
+    };
+    std::stringstream out{};
+    out << "Latency (us) p50 " << percentile(0.5) << " p90 "
+        << percentile(0.9) << " p99 " << percentile(0.99) << " p99.9 "
+        << percentile(0.999) << " max " << (latency.Max() / 1000) << "\n";
+
+    for (const auto& [code, total] : status) {
+        out << "   " << get_status_name(code) << ": " << total << "\n";
+    }
+
+    return out.str();
+}
+
+// Usage: snapshot --instance N --file <path> [--window N]
+//
+// Lists every kind of wallet object at once, then fetches details and
+// balances through a bounded window and writes a sorted NDJSON snapshot (see
+// Snapshot). Seeds are recorded by id only.
+void CLI::snapshot(const std::string& in, const zmq::socket::Dealer& socket)
+{
+    struct State {
+        std::mutex lock_{};
+        std::map<proto::RPCCommandType, std::vector<std::string>> lists_{};
+        std::vector<Snapshot::Record> records_{};
+        std::size_t failed_{0};
+    };
+
+    int instance{-1};
+    std::string file{};
+    std::size_t window{FANOUT_WINDOW};
+
+    po::options_description options("Options");
+    options.add_options()("instance", po::value<int>(&instance), "<number>");
+    options.add_options()("file", po::value<std::string>(&file), "<path>");
+    options.add_options()(
+        "window", po::value<std::size_t>(&window), "<number>");
+    auto hasOptions = parse_command(in, options);
+
+    if (!hasOptions) {
+        print_options_description(options);
+        return;
+    }
+
+    if (-1 == instance) {
+        LogOutput(__FUNCTION__)(": Missing instance option").Flush();
+
+        return;
+    }
+
+    if (file.empty()) {
+        LogOutput(__FUNCTION__)(": Missing file option").Flush();
+
+        return;
+    }
+
+    Snapshot::Info info{};
+    info.instance_ = instance;
+    info.endpoint_ = endpoint_;
+    info.created_ = std::chrono::duration_cast<std::chrono::seconds>(
+                        std::chrono::system_clock::now().time_since_epoch())
+                        .count();
+    const auto start = std::chrono::steady_clock::now();
+    const std::chrono::seconds timeout{RPC_TIMEOUT_SECONDS};
+    auto state = std::make_shared<State>();
+    auto slots = std::make_shared<Window>(window, true);
+    bool complete{true};
+    // Sends a command whose reply is handled under the state lock. Once the
+    // window has timed out nothing more is sent.
+    const auto fetch = [&](const proto::RPCCommand& command,
+                           std::function<void(const proto::RPCResponse&)>
+                               handler) {
+        const auto valid = validate(command);
+
+        OT_ASSERT(valid)
+
+        if ((false == complete) || (false == slots->Acquire(timeout))) {
+            return false;
+        }
+
+        const auto sent = send_message(
+            socket, command, [state, slots, handler](const auto& reply) {
+                Lock lock(state->lock_);
+                handler(reply);
+                lock.unlock();
+                slots->Release();
+            },
+            {},
+            slots);
+
+        if (false == sent) { slots->Release(); }
+
+        return true;
+    };
+    const auto failed = [](const proto::RPCResponse& reply) {
+        return (0 < reply.status_size()) &&
+               (proto::RPCRESPONSE_SUCCESS != reply.status(0).code());
+    };
+    const std::map<proto::RPCCommandType, std::string> lists{
+        {proto::RPCCOMMAND_LISTACCOUNTS, "account"},
+        {proto::RPCCOMMAND_LISTCONTACTS, "contact"},
+        {proto::RPCCOMMAND_LISTHDSEEDS, "seed"},
+        {proto::RPCCOMMAND_LISTNYMS, "nym"},
+        {proto::RPCCOMMAND_LISTSERVERCONTRACTS, "server"},
+        {proto::RPCCOMMAND_LISTUNITDEFINITIONS, "unit"},
+    };
+
+    for (const auto& item : lists) {
+        const auto type = item.first;
+        complete &= fetch(
+            new_command(type, instance), [state, type](const auto& reply) {
+                // NONE is how an empty list is reported
+                const auto refused =
+                    (0 < reply.status_size()) &&
+                    (proto::RPCRESPONSE_SUCCESS != reply.status(0).code()) &&
+                    (proto::RPCRESPONSE_NONE != reply.status(0).code());
+
+                if (refused) {
+                    LogOutput("snapshot: ")(get_command_name(type))(
+                        " failed: ")(get_status_name(reply.status(0).code()))
+                        .Flush();
+                    ++state->failed_;
+
+                    return;
+                }
+
+                auto& ids = state->lists_[type];
+                ids.assign(
+                    reply.identifier().begin(), reply.identifier().end());
+            });
+    }
+
+    if ((false == complete) || (false == slots->Wait(timeout))) {
+        LogOutput(__FUNCTION__)(": Timed out waiting for lists").Flush();
+        exit_status_ = 1;
+
+        return;
+    }
+
+    // A snapshot missing a whole kind of object would look like a mass
+    // deletion to diff
+    if (0 < state->failed_) {
+        LogOutput(__FUNCTION__)(": Not writing an incomplete snapshot")
+            .Flush();
+        exit_status_ = 1;
+
+        return;
+    }
+
+    // Nothing else touches the lists until the fan out below has finished
+    const auto listed = state->lists_;
+
+    for (const auto type : {proto::RPCCOMMAND_LISTCONTACTS,
+                            proto::RPCCOMMAND_LISTHDSEEDS,
+                            proto::RPCCOMMAND_LISTSERVERCONTRACTS}) {
+        if (0 == listed.count(type)) { continue; }
+
+        for (const auto& id : listed.at(type)) {
+            Snapshot::Record record{};
+            record.kind_ = lists.at(type);
+            record.id_ = id;
+            state->records_.emplace_back(std::move(record));
+        }
+    }
+
+    const auto ids = [&](const proto::RPCCommandType type) {
+        return (0 == listed.count(type)) ? std::vector<std::string>{}
+                                         : listed.at(type);
+    };
+
+    for (const auto& id : ids(proto::RPCCOMMAND_LISTNYMS)) {
+        auto command = new_command(proto::RPCCOMMAND_GETNYM, instance);
+        command.add_identifier(id);
+        complete &= fetch(command, [state, id, failed](const auto& reply) {
+            Snapshot::Record record{};
+            record.kind_ = "nym";
+            record.id_ = id;
+
+            if (failed(reply) || (0 == reply.nym_size())) {
+                ++state->failed_;
+                record.text_["status"] = "missing";
+            } else {
+                record.numbers_["revision"] = reply.nym(0).revision();
+                record.numbers_["credentials"] =
+                    reply.nym(0).activecredentials_size();
+            }
+
+            state->records_.emplace_back(std::move(record));
+        });
+    }
+
+    for (const auto& id : ids(proto::RPCCOMMAND_LISTUNITDEFINITIONS)) {
+        auto command =
+            new_command(proto::RPCCOMMAND_GETUNITDEFINITION, instance);
+        command.add_identifier(id);
+        complete &= fetch(command, [state, id, failed](const auto& reply) {
+            Snapshot::Record record{};
+            record.kind_ = "unit";
+            record.id_ = id;
+
+            if (failed(reply) || (0 == reply.unit_size())) {
+                ++state->failed_;
+                record.text_["status"] = "missing";
+            } else {
+                const auto& unit = reply.unit(0);
+                record.text_["name"] = unit.name();
+                record.text_["shortname"] = unit.shortname();
+                record.text_["issuer"] = unit.nymid();
+            }
+
+            state->records_.emplace_back(std::move(record));
+        });
+    }
+
+    const auto accounts = ids(proto::RPCCOMMAND_LISTACCOUNTS);
+
+    for (std::size_t first{0}; first < accounts.size(); first += BATCH_SIZE) {
+        const auto last = std::min<std::size_t>(
+            accounts.size(), first + BATCH_SIZE);
+        const std::vector<std::string> batch{
+            accounts.begin() + first, accounts.begin() + last};
+        auto command =
+            new_command(proto::RPCCOMMAND_GETACCOUNTBALANCE, instance);
+
+        for (const auto& id : batch) { command.add_identifier(id); }
+
+        complete &= fetch(command, [state, batch](const auto& reply) {
+            std::set<std::string> missing{batch.begin(), batch.end()};
+
+            for (const auto& balance : reply.balance()) {
+                Snapshot::Record record{};
+                record.kind_ = "account";
+                record.id_ = balance.id();
+                record.text_["label"] = balance.label();
+                record.text_["unit"] = balance.unit();
+                record.text_["owner"] = balance.owner();
+                record.text_["issuer"] = balance.issuer();
+                record.numbers_["balance"] = balance.balance();
+                record.numbers_["pending"] = balance.pendingbalance();
+                missing.erase(balance.id());
+                state->records_.emplace_back(std::move(record));
+            }
+
+            for (const auto& id : missing) {
+                Snapshot::Record record{};
+                record.kind_ = "account";
+                record.id_ = id;
+                record.text_["status"] = "missing";
+                ++state->failed_;
+                state->records_.emplace_back(std::move(record));
+            }
+        });
+    }
+
+    if ((false == complete) || (false == slots->Wait(timeout))) {
+        LogOutput(__FUNCTION__)(": Timed out waiting for replies").Flush();
+        exit_status_ = 1;
+
+        return;
+    }
+
+    info.elapsed_ms_ = std::chrono::duration_cast<std::chrono::milliseconds>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+    Lock lock(state->lock_);
+
+    if (false == Snapshot::Write(file, info, state->records_)) {
+        exit_status_ = 1;
+
+        return;
+    }
+
+    LogOutput(__FUNCTION__)(": Wrote ")(state->records_.size())(
+        " objects to ")(file)(" in ")(info.elapsed_ms_)(" ms")
+        .Flush();
+
+    if (0 < state->failed_) {
+        LogOutput(__FUNCTION__)(": ")(state->failed_)(
+            " objects could not be retrieved")
+            .Flush();
+        exit_status_ = 1;
+    }
+}
+
 void CLI::task_complete_push(const proto::RPCPush& in, const int instance)
 {
-    print_basic_info(in);
     const auto& task = in.taskcomplete();
+    const auto callback = tracker_.TaskComplete(
+        task.id(), log_correlator_.Position(), task.result());
+
+    if (tracer_) { tracer_->TaskComplete(task.id()); }
+
+    if (callback) {
+        callback(task.id(), task.result());
+
+        return;
+    }
+
+    print_basic_info(in);
+
     if (-1 != instance) { LogOutput("   Instance: ")(instance).Flush(); }
     LogOutput("   Type: TASK").Flush();
     LogOutput("   ID: ")(task.id()).Flush();
@@ -2556,7 +5518,7 @@ void CLI::transfer(const std::string& in, const zmq::socket::Dealer& socket)
     std::string sourceAccountID{""};
     std::string destinationAccountID{""};
     std::string memo{""};
-    int amount{-1};
+    std::int64_t amount{-1};
 
     po::options_description options("Options");
     options.add_options()("instance", po::value<int>(&instance), "<number>");
@@ -2569,7 +5531,8 @@ void CLI::transfer(const std::string& in, const zmq::socket::Dealer& socket)
         po::value<std::string>(&destinationAccountID),
         "<string>");
     options.add_options()("memo", po::value<std::string>(&memo), "<string>");
-    options.add_options()("amount", po::value<int>(&amount), "<number>");
+    options.add_options()(
+        "amount", po::value<std::int64_t>(&amount), "<number>");
     auto hasOptions = parse_command(in, options);
 
     if (!hasOptions) {
@@ -2610,7 +5573,7 @@ void CLI::transfer(const std::string& in, const zmq::socket::Dealer& socket)
 
     proto::RPCCommand out{};
     out.set_version(RPC_COMMAND_VERSION);
-    out.set_cookie(Identifier::Random()->str());
+    out.set_cookie(cookies_.Next());
     out.set_type(proto::RPCCOMMAND_SENDPAYMENT);
     out.set_session(instance);
 
@@ -2621,9 +5584,9 @@ void CLI::transfer(const std::string& in, const zmq::socket::Dealer& socket)
     sendpayment.set_sourceaccount(sourceAccountID);
     sendpayment.set_destinationaccount(destinationAccountID);
     if (!memo.empty()) { sendpayment.set_memo(memo); }
-    sendpayment.set_amount(static_cast<unsigned int>(amount));
+    sendpayment.set_amount(amount);
 
-    const auto valid = proto::Validate(out, VERBOSE);
+    const auto valid = validate(out);
 
     OT_ASSERT(valid)
 
@@ -2631,4 +5594,279 @@ void CLI::transfer(const std::string& in, const zmq::socket::Dealer& socket)
 
     OT_ASSERT(sent)
 }
+
+// Everything since the processor started, up to this point, counts as parsing
+bool CLI::validate(const proto::RPCCommand& command)
+{
+    if (false == bool(tracer_)) { return proto::Validate(command, VERBOSE); }
+
+    tracer_->Phase("parse", command.cookie());
+    const auto output = proto::Validate(command, VERBOSE);
+    tracer_->Phase("validate", command.cookie());
+
+    return output;
+}
+
+// Usage: workflowstats --instance N --nym <id> [--workflow <id>... |
+//                      --file <path> | --account <id>...] [--window N]
+//
+// Fetches every workflow and reports, per event type, how long workflows
+// stayed in the state that event produced and how often the event failed.
+// The dwell time of an event is the time until the next event of the same
+// workflow, so the latest event of each workflow only counts towards the
+// current state totals.
+void CLI::workflow_stats(
+    const std::string& in,
+    const zmq::socket::Dealer& socket)
+{
+    struct Stage {
+        std::uint64_t events_{0};
+        std::uint64_t failed_{0};
+        // Seconds spent before the next event
+        Histogram dwell_{WORKFLOW_HIGHEST_DWELL};
+    };
+    struct State {
+        std::mutex lock_{};
+        std::map<int, Stage> stages_{};
+        std::map<int, std::uint64_t> current_{};
+        std::uint64_t workflows_{0};
+        std::uint64_t archived_{0};
+        std::uint64_t missing_{0};
+        // Refused with an error status, or never sent
+        std::uint64_t failed_{0};
+    };
+
+    int instance{-1};
+    std::string nymID{};
+    std::vector<std::string> workflows{};
+    std::vector<std::string> accounts{};
+    std::string file{};
+    std::size_t window{FANOUT_WINDOW};
+    std::size_t batchSize{BATCH_SIZE};
+
+    po::options_description options("Options");
+    options.add_options()("instance", po::value<int>(&instance), "<number>");
+    options.add_options()("nym", po::value<std::string>(&nymID), "<string>");
+    options.add_options()(
+        "workflow",
+        po::value<std::vector<std::string>>(&workflows)->multitoken(),
+        "<string>...");
+    options.add_options()("file", po::value<std::string>(&file), "<path>");
+    options.add_options()(
+        "account",
+        po::value<std::vector<std::string>>(&accounts)->multitoken(),
+        "<string>... Analyze every workflow in the account activity");
+    options.add_options()(
+        "window", po::value<std::size_t>(&window), "<number>");
+    options.add_options()(
+        "batchsize", po::value<std::size_t>(&batchSize), "<number>");
+    auto hasOptions = parse_command(in, options);
+
+    if (!hasOptions) {
+        print_options_description(options);
+        exit_status_ = 1;
+
+        return;
+    }
+
+    if (-1 == instance) {
+        LogOutput(__FUNCTION__)(": Missing instance option").Flush();
+        exit_status_ = 1;
+
+        return;
+    }
+
+    if (nymID.empty()) {
+        LogOutput(__FUNCTION__)(": Missing nym id option").Flush();
+        exit_status_ = 1;
+
+        return;
+    }
+
+    if ((false == file.empty()) && (false == read_items(file, workflows))) {
+        LogOutput(__FUNCTION__)(": Unable to read ")(file).Flush();
+        exit_status_ = 1;
+
+        return;
+    }
+
+    batchSize = std::max(batchSize, std::size_t{1});
+
+    for (std::size_t first{0}; first < accounts.size(); first += batchSize) {
+        const auto last = std::min(accounts.size(), first + batchSize);
+        auto command =
+            new_command(proto::RPCCOMMAND_GETACCOUNTACTIVITY, instance);
+
+        for (auto i = first; i < last; ++i) {
+            command.add_identifier(accounts.at(i));
+        }
+
+        proto::RPCResponse activity{};
+
+        if (false == request(socket, command, activity)) {
+            LogOutput(__FUNCTION__)(": No reply to GETACCOUNTACTIVITY").Flush();
+            exit_status_ = 1;
+
+            return;
+        }
+
+        for (const auto& event : activity.accountevent()) {
+            if (false == event.workflow().empty()) {
+                workflows.emplace_back(event.workflow());
+            }
+        }
+    }
+
+    std::sort(workflows.begin(), workflows.end());
+    workflows.erase(
+        std::unique(workflows.begin(), workflows.end()), workflows.end());
+
+    if (workflows.empty()) {
+        LogOutput(__FUNCTION__)(": No workflows to analyze").Flush();
+
+        return;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const std::chrono::seconds timeout{RPC_TIMEOUT_SECONDS};
+    auto state = std::make_shared<State>();
+    auto slots = std::make_shared<Window>(window, true);
+
+    for (std::size_t first{0}; first < workflows.size(); first += batchSize) {
+        const auto last = std::min(workflows.size(), first + batchSize);
+        auto command = new_command(proto::RPCCOMMAND_GETWORKFLOW, instance);
+
+        for (auto i = first; i < last; ++i) {
+            auto& getworkflow = *command.add_getworkflow();
+            getworkflow.set_version(GETWORKFLOW_VERSION);
+            getworkflow.set_nymid(nymID);
+            getworkflow.set_workflowid(workflows.at(i));
+        }
+
+        const auto valid = validate(command);
+
+        OT_ASSERT(valid)
+
+        if (false == slots->Acquire(timeout)) {
+            LogOutput(__FUNCTION__)(": Timed out waiting for replies").Flush();
+            exit_status_ = 1;
+
+            return;
+        }
+
+        const auto requested = last - first;
+        const auto sent = send_message(
+            socket, command, [state, slots, requested](const auto& reply) {
+                std::vector<std::pair<std::int64_t, const proto::PaymentEvent*>>
+                    events{};
+                std::size_t failed{0};
+
+                // NONE is how an unknown workflow is reported
+                for (const auto& status : reply.status()) {
+                    if ((proto::RPCRESPONSE_SUCCESS != status.code()) &&
+                        (proto::RPCRESPONSE_NONE != status.code())) {
+                        ++failed;
+                    }
+                }
+
+                // A refused command carries one status for the whole batch
+                if ((1 == reply.status_size()) && (1 == failed)) {
+                    failed = requested;
+                }
+
+                failed = std::min(failed, requested);
+                const auto found = std::min<std::size_t>(
+                    requested - failed, reply.workflow_size());
+                Lock lock(state->lock_);
+                state->failed_ += failed;
+                state->missing_ += requested - failed - found;
+
+                for (const auto& workflow : reply.workflow()) {
+                    ++state->workflows_;
+
+                    if (workflow.archived()) { ++state->archived_; }
+
+                    events.clear();
+
+                    for (const auto& event : workflow.event()) {
+                        events.emplace_back(event.time(), &event);
+                    }
+
+                    std::stable_sort(
+                        events.begin(),
+                        events.end(),
+                        [](const auto& lhs, const auto& rhs) {
+                            return lhs.first < rhs.first;
+                        });
+
+                    for (std::size_t i{0}; i < events.size(); ++i) {
+                        const auto& event = *events.at(i).second;
+                        auto& stage = state->stages_[event.type()];
+                        ++stage.events_;
+
+                        if (false == event.success()) { ++stage.failed_; }
+
+                        if (i + 1 < events.size()) {
+                            const auto dwell =
+                                events.at(i + 1).first - events.at(i).first;
+                            stage.dwell_.Record(
+                                std::max<std::int64_t>(0, dwell));
+                        } else {
+                            ++state->current_[event.type()];
+                        }
+                    }
+                }
+
+                lock.unlock();
+                slots->Release();
+            },
+            {},
+            slots);
+
+        if (false == sent) {
+            Lock lock(state->lock_);
+            state->failed_ += requested;
+            lock.unlock();
+            slots->Release();
+        }
+    }
+
+    if (false == slots->Wait(timeout)) {
+        LogOutput(__FUNCTION__)(": Timed out waiting for replies").Flush();
+        exit_status_ = 1;
+
+        return;
+    }
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+    Lock lock(state->lock_);
+    std::stringstream out{};
+    out << std::left << std::setw(8) << "Event" << std::right << std::setw(10)
+        << "Count" << std::setw(10) << "Failed" << std::setw(9) << "Rate"
+        << std::setw(10) << "Current" << std::setw(10) << "p50 (s)"
+        << std::setw(10) << "p90 (s)" << std::setw(10) << "p99 (s)"
+        << std::setw(10) << "max (s)" << "\n";
+
+    for (const auto& [type, stage] : state->stages_) {
+        const auto& dwell = stage.dwell_;
+        out << std::left << std::setw(8) << type << std::right << std::setw(10)
+            << stage.events_ << std::setw(10) << stage.failed_
+            << std::setw(8) << std::fixed << std::setprecision(1)
+            << (100.0 * stage.failed_ / stage.events_) << "%"
+            << std::setw(10) << state->current_[type] << std::setw(10)
+            << dwell.ValueAt(0.5) << std::setw(10) << dwell.ValueAt(0.9)
+            << std::setw(10) << dwell.ValueAt(0.99) << std::setw(10)
+            << dwell.Max() << "\n";
+    }
+
+    out << state->workflows_ << " workflows (" << state->archived_
+        << " archived, " << state->missing_ << " not found, "
+        << state->failed_ << " failed) in " << elapsed.count() << " ms";
+    LogOutput(out.str()).Flush();
+
+    if (0 < state->failed_) { exit_status_ = 1; }
+}
+
+CLI::~CLI() { scheduler_.Stop(); }
 }  // namespace opentxs::otctl
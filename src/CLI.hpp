@@ -9,29 +9,62 @@
 
 #include <boost/program_options.hpp>
 
+#include <chrono>
+#include <deque>
 #include <functional>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "ActivityStore.hpp"
+#include "BenchReport.hpp"
+#include "CookieGenerator.hpp"
+#include "LoadGenerator.hpp"
+#include "LogArchive.hpp"
+#include "LogCorrelator.hpp"
+#include "ObjectCache.hpp"
+#include "RequestTracker.hpp"
+#include "Scheduler.hpp"
+#include "Tracer.hpp"
+#include "TrafficRecorder.hpp"
+#include "Window.hpp"
 
 namespace po = boost::program_options;
 
 namespace opentxs::otctl
 {
+class ReplyBenchmark;
+
 class CLI
 {
 public:
     CLI(const api::Context& ot, const po::variables_map& options);
 
     int Run();
+    int Run(const std::vector<std::string>& command);
 
-    ~CLI() = default;
+    ~CLI();
 
 private:
-    using PushHandler = void (*)(const proto::RPCPush&, const int);
-    using ResponseHandler = void (*)(const proto::RPCResponse&);
-    using Processor =
-        void (*)(const std::string&, const network::zeromq::socket::Dealer&);
+    friend class ReplyBenchmark;
+
+    using PushHandler = void (CLI::*)(const proto::RPCPush&, const int);
+    using ResponseHandler = void (CLI::*)(const proto::RPCResponse&);
+    using Processor = void (CLI::*)(
+        const std::string&,
+        const network::zeromq::socket::Dealer&);
+
+    // Client side window over the identifiers returned by a list command
+    struct Page {
+        std::size_t start_{0};
+        std::size_t limit_{0};
+        std::size_t size_{0};
+        std::string after_{};
+    };
 
     static const std::map<std::string, proto::RPCCommandType> commands_;
+    static const std::map<std::string, Processor> composites_;
     static const std::map<proto::RPCPushType, PushHandler> push_handlers_;
     static const std::map<proto::RPCCommandType, ResponseHandler>
         response_handlers_;
@@ -44,205 +77,288 @@ private:
     const po::variables_map& options_;
     const std::string endpoint_;
     std::vector<std::string> history_;
+    CookieGenerator cookies_;
+    RequestTracker tracker_;
+    LogCorrelator log_correlator_;
+    std::mutex context_lock_;
+    std::map<std::string, Page> pages_;
+    // Cookies in the order their page was set, oldest evicted first
+    std::deque<std::string> page_order_;
+    std::map<std::string, std::vector<std::string>> batches_;
+    std::deque<std::string> batch_order_;
+    // Only sends from the capturing thread are captured. Retries and other
+    // threads keep sending while a capture is in progress.
+    mutable std::mutex capture_lock_;
+    std::vector<proto::RPCCommand>* capture_;
+    std::thread::id capturing_;
+    std::mutex load_lock_;
+    std::shared_ptr<LoadGenerator> load_;
+    std::unique_ptr<TrafficRecorder> recorder_;
+    int exit_status_;
+    std::unique_ptr<Tracer> tracer_;
+    const std::size_t retries_;
+    // Delayed resends. Stopped before anything it could touch is destroyed.
+    Scheduler scheduler_;
+    // Used by reply and push handlers, so these must outlive socket_
+    std::unique_ptr<ObjectCache> cache_;
+    std::unique_ptr<ActivityStore> activity_;
     OTZMQListenCallback callback_;
     OTZMQDealerSocket socket_;
+    // Every otagent listed by --fleet, by endpoint
+    std::map<std::string, OTZMQDealerSocket> fleet_;
+    std::unique_ptr<LogArchive> log_archive_;
     OTZMQListenCallback log_callback_;
     OTZMQSubscribeSocket log_subscriber_;
 
-    static void accept_pending_payment(
+    void accept_pending_payment(
+        const std::string& in,
+        const network::zeromq::socket::Dealer& socket);
+
+    void add_client_session(
         const std::string& in,
         const network::zeromq::socket::Dealer& socket);
 
-    static void add_client_session(
+    void add_contact(
         const std::string& in,
         const network::zeromq::socket::Dealer& socket);
 
-    static void add_contact(
+    static void add_page_options(po::options_description& options, Page& page);
+
+    void add_server_session(
         const std::string& in,
         const network::zeromq::socket::Dealer& socket);
 
-    static void add_server_session(
+    void balances(
         const std::string& in,
         const network::zeromq::socket::Dealer& socket);
 
-    static void create_account(
+    void bench(
         const std::string& in,
         const network::zeromq::socket::Dealer& socket);
 
-    static void create_compatible_account(
+    bool capture(
+        const std::string& line,
+        std::vector<proto::RPCCommand>& commands);
+
+    void create_account(
         const std::string& in,
         const network::zeromq::socket::Dealer& socket);
 
-    static void create_nym(
+    void create_compatible_account(
         const std::string& in,
         const network::zeromq::socket::Dealer& socket);
 
-    static void create_unit_definition(
+    void create_nym(
         const std::string& in,
         const network::zeromq::socket::Dealer& socket);
 
+    void create_unit_definition(
+        const std::string& in,
+        const network::zeromq::socket::Dealer& socket);
+
+    void dispatch(const proto::RPCResponse& response);
+
     void execute(std::string cmd, std::string arguments);
 
-    static void get_account_activity(
+    void fleet(
         const std::string& in,
         const network::zeromq::socket::Dealer& socket);
 
-    static void get_account_balance(
+    void get_account_activity(
         const std::string& in,
         const network::zeromq::socket::Dealer& socket);
 
-    static void get_compatible_accounts(
+    void get_account_balance(
         const std::string& in,
         const network::zeromq::socket::Dealer& socket);
 
-    static void get_nym(
+    void get_compatible_accounts(
         const std::string& in,
         const network::zeromq::socket::Dealer& socket);
 
-    static void get_pending_payments(
+    void get_nym(
         const std::string& in,
         const network::zeromq::socket::Dealer& socket);
 
-    static void get_seed(
+    void get_pending_payments(
         const std::string& in,
         const network::zeromq::socket::Dealer& socket);
 
-    static void get_server_contract(
+    void get_seed(
         const std::string& in,
         const network::zeromq::socket::Dealer& socket);
 
-    static void get_transaction_data(
+    void get_server_contract(
         const std::string& in,
         const network::zeromq::socket::Dealer& socket);
 
-    static void get_workflow(
+    void get_transaction_data(
         const std::string& in,
         const network::zeromq::socket::Dealer& socket);
 
-    static void import_seed(
+    void get_unit_definition(
         const std::string& in,
         const network::zeromq::socket::Dealer& socket);
 
-    static void import_server_contract(
+    void get_workflow(
         const std::string& in,
         const network::zeromq::socket::Dealer& socket);
 
-    static void issue_unit_definition(
+    void import_seed(
         const std::string& in,
         const network::zeromq::socket::Dealer& socket);
 
-    static void list_accounts(
+    void import_server_contract(
         const std::string& in,
         const network::zeromq::socket::Dealer& socket);
 
-    static void list_client_sessions(
+    void issue_unit_definition(
         const std::string& in,
         const network::zeromq::socket::Dealer& socket);
 
-    static void list_contacts(
+    void list_accounts(
         const std::string& in,
         const network::zeromq::socket::Dealer& socket);
 
-    static void list_nyms(
+    void list_client_sessions(
         const std::string& in,
         const network::zeromq::socket::Dealer& socket);
 
-    static void list_seeds(
+    void list_contacts(
         const std::string& in,
         const network::zeromq::socket::Dealer& socket);
 
-    static void list_server_contracts(
+    void list_nyms(
         const std::string& in,
         const network::zeromq::socket::Dealer& socket);
 
-    static void list_server_sessions(
+    void list_seeds(
         const std::string& in,
         const network::zeromq::socket::Dealer& socket);
 
-    static void list_unit_definitions(
+    void list_server_contracts(
         const std::string& in,
         const network::zeromq::socket::Dealer& socket);
 
-    static void move_funds(
+    void list_server_sessions(
         const std::string& in,
         const network::zeromq::socket::Dealer& socket);
 
-    static void register_nym(
+    void list_unit_definitions(
         const std::string& in,
         const network::zeromq::socket::Dealer& socket);
 
-    static void send_cheque(
+    void move_funds(
         const std::string& in,
         const network::zeromq::socket::Dealer& socket);
 
-    static void send_payment(
+    void payments(
         const std::string& in,
         const network::zeromq::socket::Dealer& socket);
 
-    static void transfer(
+    void provision(
         const std::string& in,
         const network::zeromq::socket::Dealer& socket);
 
-    static void accept_pending_payment_response(const proto::RPCResponse& in);
+    void reconcile(
+        const std::string& in,
+        const network::zeromq::socket::Dealer& socket);
 
-    static void add_contact_response(const proto::RPCResponse& in);
+    void register_nym(
+        const std::string& in,
+        const network::zeromq::socket::Dealer& socket);
 
-    static void add_session_response(const proto::RPCResponse& in);
+    void replay(
+        const std::string& in,
+        const network::zeromq::socket::Dealer& socket);
+
+    void send_cheque(
+        const std::string& in,
+        const network::zeromq::socket::Dealer& socket);
+
+    void send_payment(
+        const std::string& in,
+        const network::zeromq::socket::Dealer& socket);
 
-    static void create_account_response(const proto::RPCResponse& in);
+    void snapshot(
+        const std::string& in,
+        const network::zeromq::socket::Dealer& socket);
 
-    static void create_nym_response(const proto::RPCResponse& in);
+    void transfer(
+        const std::string& in,
+        const network::zeromq::socket::Dealer& socket);
+
+    void workflow_stats(
+        const std::string& in,
+        const network::zeromq::socket::Dealer& socket);
 
-    static void create_unit_definition_response(const proto::RPCResponse& in);
+    void accept_pending_payment_response(const proto::RPCResponse& in);
 
-    static void get_account_activity_response(const proto::RPCResponse& in);
+    void add_contact_response(const proto::RPCResponse& in);
 
-    static void get_account_balance_response(const proto::RPCResponse& in);
+    void add_session_response(const proto::RPCResponse& in);
 
-    static void get_compatible_accounts_response(const proto::RPCResponse& in);
+    void create_account_response(const proto::RPCResponse& in);
 
-    static void get_nym_response(const proto::RPCResponse& in);
+    void create_nym_response(const proto::RPCResponse& in);
 
-    static void get_pending_payments_response(const proto::RPCResponse& in);
+    void create_unit_definition_response(const proto::RPCResponse& in);
 
-    static void get_seed_response(const proto::RPCResponse& in);
+    void get_account_activity_response(const proto::RPCResponse& in);
 
-    static void get_transaction_data_response(const proto::RPCResponse& in);
+    void get_account_balance_response(const proto::RPCResponse& in);
 
-    static void get_server_contract_response(const proto::RPCResponse& in);
+    void get_compatible_accounts_response(const proto::RPCResponse& in);
 
-    static void get_workflow_response(const proto::RPCResponse& in);
+    void get_nym_response(const proto::RPCResponse& in);
 
-    static void import_seed_response(const proto::RPCResponse& in);
+    void get_pending_payments_response(const proto::RPCResponse& in);
 
-    static void import_server_contract_response(const proto::RPCResponse& in);
+    void get_seed_response(const proto::RPCResponse& in);
 
-    static void issue_unit_definition_response(const proto::RPCResponse& in);
+    void get_transaction_data_response(const proto::RPCResponse& in);
 
-    static void list_accounts_response(const proto::RPCResponse& in);
+    void get_server_contract_response(const proto::RPCResponse& in);
 
-    static void list_contacts_response(const proto::RPCResponse& in);
+    void get_unit_definition_response(const proto::RPCResponse& in);
 
-    static void list_nyms_response(const proto::RPCResponse& in);
+    void get_workflow_response(const proto::RPCResponse& in);
 
-    static void list_seeds_response(const proto::RPCResponse& in);
+    void import_seed_response(const proto::RPCResponse& in);
 
-    static void list_servers_response(const proto::RPCResponse& in);
+    void import_server_contract_response(const proto::RPCResponse& in);
 
-    static void list_session_response(const proto::RPCResponse& in);
+    void issue_unit_definition_response(const proto::RPCResponse& in);
 
-    static void list_unit_definitions_response(const proto::RPCResponse& in);
+    void list_accounts_response(const proto::RPCResponse& in);
 
-    static void move_funds_response(const proto::RPCResponse& in);
+    void list_contacts_response(const proto::RPCResponse& in);
 
-    static void register_nym_response(const proto::RPCResponse& in);
+    void list_nyms_response(const proto::RPCResponse& in);
 
-    static void send_payment_response(const proto::RPCResponse& in);
+    void list_seeds_response(const proto::RPCResponse& in);
 
-    static void account_event_push(
+    void list_servers_response(const proto::RPCResponse& in);
+
+    void list_session_response(const proto::RPCResponse& in);
+
+    void list_unit_definitions_response(const proto::RPCResponse& in);
+
+    void move_funds_response(const proto::RPCResponse& in);
+
+    void register_nym_response(const proto::RPCResponse& in);
+
+    void send_payment_response(const proto::RPCResponse& in);
+
+    void account_event_push(
         const proto::RPCPush& in,
         const int instance = -1);
 
+    bool from_cache(
+        const proto::RPCCommandType type,
+        const int instance,
+        const std::string& id);
+
     static std::string find_home();
 
     static std::string get_account_push_name(
@@ -252,13 +368,23 @@ private:
 
     static std::string get_json(const po::variables_map& cli);
 
+    static std::string get_json(const std::string& filename);
+
     static std::string get_socket_path(const po::variables_map& cli);
 
     static std::string get_status_name(const proto::RPCResponseCode code);
 
+    proto::RPCCommand new_command(
+        const proto::RPCCommandType type,
+        const int instance);
+
     static bool parse_command(
         const std::string& input,
         po::options_description& options);
+    static bool parse_command(
+        const std::string& input,
+        po::options_description& options,
+        const po::positional_options_description& positional);
 
     static void print_options_description(po::options_description& options);
 
@@ -266,19 +392,62 @@ private:
 
     static void print_basic_info(const proto::RPCResponse& in);
 
-    static void process_push(network::zeromq::Message& in);
+    void print_items(const proto::RPCResponse& in);
+
+    void print_page(const proto::RPCResponse& in, const std::string& label);
+
+    void process_push(network::zeromq::Message& in);
+
+    void process_reply(network::zeromq::Message& in);
 
-    static void process_reply(network::zeromq::Message& in);
+    static bool read_items(
+        const std::string& path,
+        std::vector<std::string>& items);
 
-    static bool send_message(
+    void rekey(const std::string& from, const std::string& to);
+
+    bool request(
+        const network::zeromq::socket::Dealer& socket,
+        const proto::RPCCommand& command,
+        proto::RPCResponse& reply);
+
+    static std::chrono::milliseconds retry_delay(const std::size_t attempt);
+
+    // With a window the reply latency and any RETRY status are fed back to
+    // it. Commands answered with RETRY are resent with a new cookie after a
+    // backoff and only the final reply reaches the callback.
+    bool send_message(
         const network::zeromq::socket::Dealer& socket,
-        const proto::RPCCommand command);
+        const proto::RPCCommand command,
+        RequestTracker::ReplyCallback callback = {},
+        RequestTracker::TaskCallback task = {},
+        std::shared_ptr<Window> window = {},
+        const std::size_t attempt = 0);
+
+    std::shared_ptr<LoadGenerator> start_load(
+        const std::vector<proto::RPCCommand>& commands);
+
+    void stop_load();
+
+    static std::string summarize(
+        const Histogram& latency,
+        const std::map<proto::RPCResponseCode, std::uint64_t>& status);
+
+    bool validate(const proto::RPCCommand& command);
 
     static void set_keys(
         const po::variables_map& cli,
         network::zeromq::socket::Dealer& socket);
 
-    static void task_complete_push(
+    static void set_keys(
+        const std::string& keys,
+        network::zeromq::socket::Dealer& socket);
+
+    void set_batch(const std::string& cookie, std::vector<std::string> items);
+
+    void set_page(const std::string& cookie, const Page& page);
+
+    void task_complete_push(
         const proto::RPCPush& in,
         const int instance = -1);
 
@@ -286,6 +455,8 @@ private:
 
     void remote_log(network::zeromq::Message& in);
 
+    void show_logs(const std::string& id) const;
+
     CLI() = delete;
 
     CLI(const CLI&) = delete;
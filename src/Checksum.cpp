@@ -0,0 +1,48 @@
+// Copyright (c) 2019 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "Checksum.hpp"
+
+#include <array>
+
+namespace
+{
+std::array<std::uint32_t, 256> make_table()
+{
+    std::array<std::uint32_t, 256> output{};
+
+    for (std::uint32_t i{0}; i < output.size(); ++i) {
+        auto value = i;
+
+        for (int bit{0}; bit < 8; ++bit) {
+            value = (value & 1) ? (0xEDB88320 ^ (value >> 1)) : (value >> 1);
+        }
+
+        output[i] = value;
+    }
+
+    return output;
+}
+
+const auto table_ = make_table();
+}  // namespace
+
+namespace opentxs::otctl
+{
+std::uint32_t crc32(
+    const void* data,
+    const std::size_t size,
+    const std::uint32_t crc)
+{
+    const auto* bytes = static_cast<const std::uint8_t*>(data);
+    auto output = ~crc;
+
+    for (std::size_t i{0}; i < size; ++i) {
+        output = table_[(output ^ bytes[i]) & 0xFF] ^ (output >> 8);
+    }
+
+    return ~output;
+}
+}  // namespace opentxs::otctl
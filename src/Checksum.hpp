@@ -0,0 +1,18 @@
+// Copyright (c) 2019 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace opentxs::otctl
+{
+// CRC-32 (IEEE 802.3), continuing from crc when checksumming in pieces
+std::uint32_t crc32(
+    const void* data,
+    const std::size_t size,
+    const std::uint32_t crc = 0);
+}  // namespace opentxs::otctl
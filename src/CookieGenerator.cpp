@@ -0,0 +1,63 @@
+// Copyright (c) 2019 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "CookieGenerator.hpp"
+
+#include <random>
+
+namespace
+{
+const char hex_[] = "0123456789abcdef";
+
+std::string random_prefix()
+{
+    static_assert(
+        opentxs::otctl::CookieGenerator::PrefixSize ==
+        opentxs::otctl::CookieGenerator::CounterSize);
+
+    std::random_device device{};
+    const auto value = (std::uint64_t{device()} << 32) | device();
+    std::string output(opentxs::otctl::CookieGenerator::PrefixSize, '0');
+    opentxs::otctl::CookieGenerator::Encode(value, &output[0]);
+
+    return output;
+}
+}  // namespace
+
+namespace opentxs::otctl
+{
+CookieGenerator::CookieGenerator()
+    : prefix_(random_prefix())
+    , counter_(0)
+{
+}
+
+void CookieGenerator::Encode(const std::uint64_t counter, char* out)
+{
+    auto value = counter;
+
+    for (auto i = CounterSize; 0 < i; --i) {
+        out[i - 1] = hex_[value & 0xF];
+        value >>= 4;
+    }
+}
+
+std::string CookieGenerator::Next()
+{
+    std::string output{};
+    output.reserve(Size);
+    output.append(prefix_);
+    output.push_back('-');
+    output.resize(Size);
+    Encode(counter_.fetch_add(1), &output[PrefixSize + 1]);
+
+    return output;
+}
+
+std::uint64_t CookieGenerator::Reserve(const std::uint64_t count)
+{
+    return counter_.fetch_add(count);
+}
+}  // namespace opentxs::otctl
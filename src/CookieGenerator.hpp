@@ -0,0 +1,48 @@
+// Copyright (c) 2019 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace opentxs::otctl
+{
+// Command cookies of the form <session prefix>-<counter>
+//
+// The prefix is 16 random hex digits chosen once per process and the counter
+// is 16 zero padded hex digits, so every cookie has the same length and
+// cookies from one process sort in the order they were issued.
+class CookieGenerator
+{
+public:
+    static constexpr std::size_t PrefixSize{16};
+    static constexpr std::size_t CounterSize{16};
+    static constexpr std::size_t Size{PrefixSize + 1 + CounterSize};
+
+    // Writes the CounterSize hex digits of counter to out
+    static void Encode(const std::uint64_t counter, char* out);
+
+    std::string Next();
+    const std::string& Prefix() const { return prefix_; }
+    // Claims count consecutive counter values and returns the first one
+    std::uint64_t Reserve(const std::uint64_t count);
+
+    CookieGenerator();
+
+    ~CookieGenerator() = default;
+
+private:
+    const std::string prefix_;
+    std::atomic<std::uint64_t> counter_;
+
+    CookieGenerator(const CookieGenerator&) = delete;
+    CookieGenerator(CookieGenerator&&) = delete;
+    CookieGenerator& operator=(const CookieGenerator&) = delete;
+    CookieGenerator& operator=(CookieGenerator&&) = delete;
+};
+}  // namespace opentxs::otctl
@@ -0,0 +1,131 @@
+// Copyright (c) 2019 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "Histogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+int bit_length(const std::uint64_t value)
+{
+    int output{0};
+
+    for (auto v = value; 0 != v; v >>= 1) { ++output; }
+
+    return output;
+}
+}  // namespace
+
+namespace opentxs::otctl
+{
+Histogram::Histogram(const std::int64_t highest, const int digits)
+    : highest_(std::max<std::int64_t>(highest, 2))
+    , sub_bucket_half_magnitude_(0)
+    , sub_bucket_half_count_(0)
+    , sub_bucket_mask_(0)
+    , counts_()
+    , count_(0)
+    , min_(std::numeric_limits<std::int64_t>::max())
+    , max_(0)
+    , total_(0)
+{
+    // Enough linear sub-buckets to resolve the requested number of digits
+    const auto precision = static_cast<std::uint64_t>(
+        2 * std::pow(10, std::min(std::max(digits, 1), 5)));
+    const auto sub_bucket_count = std::uint64_t{1}
+                                  << bit_length(precision - 1);
+    sub_bucket_half_magnitude_ = bit_length(sub_bucket_count) - 2;
+    sub_bucket_half_count_ = static_cast<std::int64_t>(sub_bucket_count / 2);
+    sub_bucket_mask_ = static_cast<std::int64_t>(sub_bucket_count - 1);
+    counts_.resize(index(highest_) + 1, 0);
+}
+
+std::size_t Histogram::index(const std::int64_t value) const
+{
+    const auto bucket =
+        bit_length(static_cast<std::uint64_t>(value | sub_bucket_mask_)) -
+        (sub_bucket_half_magnitude_ + 1);
+    const auto sub = value >> bucket;
+
+    return static_cast<std::size_t>(
+        (static_cast<std::int64_t>(bucket + 1)
+         << sub_bucket_half_magnitude_) +
+        (sub - sub_bucket_half_count_));
+}
+
+double Histogram::Mean() const
+{
+    return (0 == count_) ? 0.0 : total_ / static_cast<double>(count_);
+}
+
+void Histogram::Merge(const Histogram& other)
+{
+    if (0 == other.count_) { return; }
+
+    for (std::size_t i{0}; i < other.counts_.size(); ++i) {
+        if (0 == other.counts_.at(i)) { continue; }
+
+        const auto position = std::min(
+            index(std::min(other.value(i), highest_)), counts_.size() - 1);
+        counts_.at(position) += other.counts_.at(i);
+    }
+
+    count_ += other.count_;
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+    total_ += other.total_;
+}
+
+void Histogram::Record(const std::int64_t value)
+{
+    const auto clamped = std::min(std::max<std::int64_t>(value, 0), highest_);
+    ++counts_.at(std::min(index(clamped), counts_.size() - 1));
+    ++count_;
+    min_ = std::min(min_, clamped);
+    max_ = std::max(max_, clamped);
+    total_ += static_cast<double>(clamped);
+}
+
+std::int64_t Histogram::value(const std::size_t index) const
+{
+    auto bucket =
+        static_cast<std::int64_t>(index >> sub_bucket_half_magnitude_) - 1;
+    const auto mask = static_cast<std::size_t>(sub_bucket_half_count_ - 1);
+    auto sub = static_cast<std::int64_t>(index & mask) + sub_bucket_half_count_;
+
+    if (0 > bucket) {
+        sub -= sub_bucket_half_count_;
+        bucket = 0;
+    }
+
+    // Report the highest value which shares this slot
+    return ((sub + 1) << bucket) - 1;
+}
+
+std::int64_t Histogram::ValueAt(const double quantile) const
+{
+    if (0 == count_) { return 0; }
+
+    const auto target = std::max<std::uint64_t>(
+        static_cast<std::uint64_t>(
+            std::ceil(std::min(std::max(quantile, 0.0), 1.0) *
+                      static_cast<double>(count_))),
+        1);
+    std::uint64_t seen{0};
+
+    for (std::size_t i{0}; i < counts_.size(); ++i) {
+        seen += counts_.at(i);
+
+        if (seen >= target) {
+            return std::min(std::max(value(i), min_), max_);
+        }
+    }
+
+    return max_;
+}
+}  // namespace opentxs::otctl
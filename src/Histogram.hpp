@@ -0,0 +1,49 @@
+// Copyright (c) 2019 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace opentxs::otctl
+{
+// High dynamic range histogram of non-negative integers
+//
+// Values are kept in log-linear buckets so that every recorded value can be
+// reported to within the configured number of significant decimal digits,
+// from 1 up to the highest trackable value, in constant memory. Larger values
+// are clamped.
+class Histogram
+{
+public:
+    std::uint64_t Count() const { return count_; }
+    std::int64_t Max() const { return max_; }
+    double Mean() const;
+    std::int64_t Min() const { return (0 == count_) ? 0 : min_; }
+    // Smallest recorded value which is at least the given fraction (0 to 1) of
+    // all recorded values
+    std::int64_t ValueAt(const double quantile) const;
+
+    void Merge(const Histogram& other);
+    void Record(const std::int64_t value);
+
+    Histogram(const std::int64_t highest, const int digits = 3);
+
+private:
+    std::int64_t highest_;
+    int sub_bucket_half_magnitude_;
+    std::int64_t sub_bucket_half_count_;
+    std::int64_t sub_bucket_mask_;
+    std::vector<std::uint64_t> counts_;
+    std::uint64_t count_;
+    std::int64_t min_;
+    std::int64_t max_;
+    double total_;
+
+    std::size_t index(const std::int64_t value) const;
+    std::int64_t value(const std::size_t index) const;
+};
+}  // namespace opentxs::otctl
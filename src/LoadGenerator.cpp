@@ -0,0 +1,194 @@
+// Copyright (c) 2019 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "LoadGenerator.hpp"
+
+#include <cstdlib>
+
+#define LOAD_TIMEOUT_SECONDS 60
+
+namespace zmq = opentxs::network::zeromq;
+
+namespace opentxs::otctl
+{
+LoadGenerator::LoadGenerator(
+    CookieGenerator& cookies,
+    const std::vector<proto::RPCCommand>& commands,
+    TrafficRecorder* recorder)
+    : cookies_(cookies)
+    , recorder_(recorder)
+    , templates_()
+    , base_(0)
+    , count_(0)
+    , start_()
+    , sent_()
+    , latency_()
+    , status_()
+    , received_(0)
+    , window_()
+{
+    for (std::size_t index{0}; index < commands.size(); ++index) {
+        const auto& command = commands.at(index);
+        const auto& cookie = command.cookie();
+
+        if ((CookieGenerator::Size != cookie.size()) ||
+            (0 != cookie.compare(
+                      0, CookieGenerator::PrefixSize, cookies_.Prefix()))) {
+            LogOutput(__FUNCTION__)(": Command has a foreign cookie").Flush();
+
+            continue;
+        }
+
+        Template item{command.SerializeAsString(), 0, index};
+        const auto position = item.bytes_.find(cookie);
+
+        if (std::string::npos == position) {
+            LogOutput(__FUNCTION__)(": Cookie not found in serialized command")
+                .Flush();
+
+            continue;
+        }
+
+        item.offset_ = position + CookieGenerator::PrefixSize + 1;
+        templates_.emplace_back(std::move(item));
+    }
+}
+
+bool LoadGenerator::Reply(const proto::RPCResponse& in)
+{
+    const auto& cookie = in.cookie();
+
+    if ((CookieGenerator::Size != cookie.size()) ||
+        (0 != cookie.compare(
+                  0, CookieGenerator::PrefixSize, cookies_.Prefix()))) {
+        return false;
+    }
+
+    const auto counter = std::strtoull(
+        cookie.c_str() + CookieGenerator::PrefixSize + 1, nullptr, 16);
+    const auto base = base_.load();
+
+    if ((counter < base) || (counter - base >= count_.load())) {
+        return false;
+    }
+
+    const auto index = counter - base;
+    const auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         Clock::now() - start_)
+                         .count();
+    std::int64_t expected{-1};
+
+    // Duplicate replies must not release the window twice
+    if (false == latency_[index].compare_exchange_strong(
+                     expected, now - sent_[index].load())) {
+        return true;
+    }
+
+    status_[index].store(
+        (0 < in.status_size()) ? in.status(0).code() : proto::RPCRESPONSE_NONE);
+    ++received_;
+    window_->Release();
+
+    return true;
+}
+
+LoadGenerator::Results LoadGenerator::Run(
+    const zmq::socket::Dealer& socket,
+    const std::uint64_t count,
+    const std::size_t window,
+    const Pacing& pacing)
+{
+    Results output{};
+
+    if (templates_.empty() || (0 == count)) { return output; }
+
+    sent_.reset(new std::atomic<std::int64_t>[count]);
+    latency_.reset(new std::atomic<std::int64_t>[count]);
+    status_.reset(new std::atomic<int>[count]);
+
+    for (std::uint64_t i{0}; i < count; ++i) {
+        sent_[i].store(-1);
+        latency_[i].store(-1);
+        status_[i].store(proto::RPCRESPONSE_INVALID);
+    }
+
+    received_.store(0);
+    window_ = std::make_unique<Window>(window);
+    start_ = Clock::now();
+    base_.store(cookies_.Reserve(count));
+    count_.store(count);
+    const std::chrono::seconds timeout{LOAD_TIMEOUT_SECONDS};
+    std::vector<std::string> buffers{};
+
+    for (const auto& item : templates_) { buffers.emplace_back(item.bytes_); }
+
+    const auto paced =
+        (0 < pacing.rate_) || (false == pacing.schedule_.empty());
+
+    for (std::uint64_t i{0}; i < count; ++i) {
+        const auto which = i % templates_.size();
+        auto intended = start_;
+
+        if (0 < pacing.rate_) {
+            intended += std::chrono::duration_cast<Clock::duration>(
+                std::chrono::duration<double>(
+                    static_cast<double>(i) / pacing.rate_));
+        } else if (false == pacing.schedule_.empty()) {
+            intended += pacing.schedule_.at(templates_.at(which).index_);
+        }
+
+        if (paced) { std::this_thread::sleep_until(intended); }
+
+        if (false == window_->Acquire(timeout)) {
+            LogOutput(__FUNCTION__)(": Timed out waiting for replies").Flush();
+
+            break;
+        }
+
+        auto& buffer = buffers.at(which);
+        CookieGenerator::Encode(
+            base_.load() + i, &buffer[templates_.at(which).offset_]);
+        auto message = zmq::Message::Factory();
+        message->AddFrame();
+        message->AddFrame(buffer.data(), buffer.size());
+        sent_[i].store(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                           (paced ? intended : Clock::now()) - start_)
+                           .count());
+
+        if (nullptr != recorder_) {
+            recorder_->Write(
+                TrafficRecorder::Direction::Command,
+                buffer.data(),
+                buffer.size());
+        }
+
+        if (false == socket.Send(message)) {
+            window_->Release();
+
+            break;
+        }
+
+        ++output.sent_;
+    }
+
+    window_->Wait(timeout);
+    output.elapsed_ = Clock::now() - start_;
+    count_.store(0);
+    output.received_ = received_.load();
+
+    for (std::uint64_t i{0}; i < output.sent_; ++i) {
+        const auto latency = latency_[i].load();
+
+        if (0 > latency) { continue; }
+
+        output.latency_.Record(latency);
+        const auto status =
+            static_cast<proto::RPCResponseCode>(status_[i].load());
+        ++output.status_[status];
+    }
+
+    return output;
+}
+}  // namespace opentxs::otctl
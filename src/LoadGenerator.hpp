@@ -0,0 +1,103 @@
+// Copyright (c) 2019 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <opentxs/opentxs.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CookieGenerator.hpp"
+#include "Histogram.hpp"
+#include "TrafficRecorder.hpp"
+#include "Window.hpp"
+
+namespace opentxs::otctl
+{
+// Sends prebuilt commands to otagent as fast as a bounded window allows, or on
+// a fixed schedule
+//
+// Each command is validated and serialized once. For every send only the
+// counter digits of the cookie are rewritten in the serialized buffer, so the
+// client spends no time on option parsing, proto construction or validation.
+//
+// When paced, latency is measured from the time each command was meant to be
+// sent rather than when it actually left, so a stall which delays later sends
+// shows up in their latency instead of disappearing from the measurement.
+class LoadGenerator
+{
+public:
+    static constexpr std::int64_t HighestLatency{3600000000000};
+
+    struct Results {
+        std::uint64_t sent_{0};
+        std::uint64_t received_{0};
+        std::chrono::nanoseconds elapsed_{0};
+        // Round trip times in nanoseconds of every received reply
+        Histogram latency_{HighestLatency};
+        std::map<proto::RPCResponseCode, std::uint64_t> status_{};
+    };
+
+    struct Pacing {
+        // Fixed arrival rate in commands per second
+        double rate_{0};
+        // Send time of commands[n], relative to the start of the run
+        std::vector<std::chrono::nanoseconds> schedule_{};
+    };
+
+    // Consumes the reply if it answers a command sent by this generator
+    bool Reply(const proto::RPCResponse& in);
+    // Sends count commands, cycling through the templates. Unless paced, each
+    // command is sent as soon as the window has room.
+    Results Run(
+        const network::zeromq::socket::Dealer& socket,
+        const std::uint64_t count,
+        const std::size_t window,
+        const Pacing& pacing);
+
+    LoadGenerator(
+        CookieGenerator& cookies,
+        const std::vector<proto::RPCCommand>& commands,
+        TrafficRecorder* recorder = nullptr);
+
+    ~LoadGenerator() = default;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Template {
+        std::string bytes_{};
+        std::size_t offset_{0};
+        // Position of the source command
+        std::size_t index_{0};
+    };
+
+    CookieGenerator& cookies_;
+    TrafficRecorder* recorder_;
+    std::vector<Template> templates_;
+    std::atomic<std::uint64_t> base_;
+    std::atomic<std::uint64_t> count_;
+    Clock::time_point start_;
+    std::unique_ptr<std::atomic<std::int64_t>[]> sent_;
+    std::unique_ptr<std::atomic<std::int64_t>[]> latency_;
+    std::unique_ptr<std::atomic<int>[]> status_;
+    std::atomic<std::uint64_t> received_;
+    std::unique_ptr<Window> window_;
+
+    LoadGenerator() = delete;
+    LoadGenerator(const LoadGenerator&) = delete;
+    LoadGenerator(LoadGenerator&&) = delete;
+    LoadGenerator& operator=(const LoadGenerator&) = delete;
+    LoadGenerator& operator=(LoadGenerator&&) = delete;
+};
+}  // namespace opentxs::otctl
@@ -0,0 +1,336 @@
+// Copyright (c) 2019 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "LogArchive.hpp"
+
+#include "MappedFile.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <limits>
+
+#define LOG_ARCHIVE_VERSION 1
+#define LOG_INDEX_INTERVAL 1024
+
+namespace fs = boost::filesystem;
+namespace po = boost::program_options;
+
+namespace
+{
+const char data_magic_[] = {'O', 'T', 'C', 'T', 'L', 'L', 'O', 'G'};
+const char index_magic_[] = {'O', 'T', 'C', 'T', 'L', 'I', 'D', 'X'};
+constexpr std::size_t header_size_{sizeof(data_magic_) + sizeof(std::uint32_t)};
+// received, level, thread size, message size
+constexpr std::size_t record_fixed_{
+    sizeof(std::uint64_t) + sizeof(std::int32_t) + sizeof(std::uint16_t) +
+    sizeof(std::uint32_t)};
+constexpr std::size_t index_entry_{2 * sizeof(std::uint64_t)};
+
+template <typename T>
+void append(std::string& out, const T value)
+{
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+T extract(const std::uint8_t* in)
+{
+    T output{};
+    std::memcpy(&output, in, sizeof(output));
+
+    return output;
+}
+
+std::string header(const char* magic)
+{
+    std::string output(magic, sizeof(data_magic_));
+    append(output, std::uint32_t{LOG_ARCHIVE_VERSION});
+
+    return output;
+}
+
+bool check_header(const opentxs::otctl::MappedFile& file, const char* magic)
+{
+    if (header_size_ > file.size()) { return false; }
+
+    return 0 == std::memcmp(file.data(), magic, sizeof(data_magic_));
+}
+
+void format_time(std::string& out, const std::uint64_t received)
+{
+    const auto seconds = static_cast<std::time_t>(received / 1000000000);
+    const auto millis = static_cast<int>((received / 1000000) % 1000);
+    std::tm tm{};
+    gmtime_r(&seconds, &tm);
+    char buf[32]{};
+    const auto size = std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%S", &tm);
+    out.append(buf, size);
+    std::snprintf(buf, sizeof(buf), ".%03dZ", millis);
+    out.append(buf);
+}
+}  // namespace
+
+namespace opentxs::otctl
+{
+LogArchive::LogArchive(const std::string& path)
+    : good_(false)
+    , data_()
+    , index_()
+    , offset_(0)
+    , count_(0)
+{
+    const auto indexPath = path + ".idx";
+    boost::system::error_code ec{};
+    const auto newData = (false == fs::exists(path, ec)) ||
+                         (0 == fs::file_size(path, ec));
+    const auto newIndex = (false == fs::exists(indexPath, ec)) ||
+                          (0 == fs::file_size(indexPath, ec));
+    data_.open(path, std::ios::out | std::ios::binary | std::ios::app);
+    index_.open(indexPath, std::ios::out | std::ios::binary | std::ios::app);
+
+    if ((false == data_.good()) || (false == index_.good())) {
+        std::cerr << "Unable to open log archive " << path << std::endl;
+
+        return;
+    }
+
+    if (newData) { data_ << header(data_magic_) << std::flush; }
+
+    if (newIndex) { index_ << header(index_magic_) << std::flush; }
+
+    offset_ = fs::file_size(path, ec);
+    good_ = (false == bool(ec));
+}
+
+int LogArchive::Query(const std::vector<std::string>& args)
+{
+    std::string file{};
+    std::int64_t from{0};
+    std::int64_t to{std::numeric_limits<std::int64_t>::max()};
+    int level{std::numeric_limits<int>::max()};
+    std::string thread{};
+    bool countOnly{false};
+
+    po::options_description options("logq");
+    options.add_options()("file", po::value<std::string>(&file), "<path>")(
+        "from", po::value<std::int64_t>(&from), "<unix time>")(
+        "to", po::value<std::int64_t>(&to), "<unix time>")(
+        "level", po::value<int>(&level), "<maximum level>")(
+        "thread", po::value<std::string>(&thread), "<thread id>")(
+        "count", po::bool_switch(&countOnly), "only print the match count");
+    po::positional_options_description positional{};
+    positional.add("file", 1);
+
+    try {
+        po::variables_map variables{};
+        po::store(
+            po::command_line_parser(args)
+                .options(options)
+                .positional(positional)
+                .run(),
+            variables);
+        po::notify(variables);
+    } catch (const po::error& e) {
+        std::cerr << "ERROR: " << e.what() << "\n\n" << options << std::endl;
+
+        return 1;
+    }
+
+    if (file.empty()) {
+        std::cerr << options << std::endl;
+
+        return 1;
+    }
+
+    const MappedFile data(file);
+
+    if ((false == data.good()) || (false == check_header(data, data_magic_))) {
+        std::cerr << file << " is not a log archive" << std::endl;
+
+        return 1;
+    }
+
+    const auto fromNs = (0 < from) ? static_cast<std::uint64_t>(from) *
+                                         1000000000
+                                   : std::uint64_t{0};
+    const auto toNs =
+        (to < std::numeric_limits<std::int64_t>::max() / 1000000000)
+            ? static_cast<std::uint64_t>(to) * 1000000000 + 999999999
+            : std::numeric_limits<std::uint64_t>::max();
+    std::size_t start{header_size_};
+    std::size_t end{data.size()};
+    const MappedFile index(file + ".idx");
+
+    // Receive times come from the wall clock, so the index narrows the scan to
+    // the blocks which can contain the requested range and every record is
+    // still checked individually.
+    if (index.good() && check_header(index, index_magic_)) {
+        const auto* entries = index.data() + header_size_;
+        const auto count = (index.size() - header_size_) / index_entry_;
+        const auto time = [&](std::size_t i) {
+            return extract<std::uint64_t>(entries + i * index_entry_);
+        };
+        const auto offset = [&](std::size_t i) {
+            return static_cast<std::size_t>(extract<std::uint64_t>(
+                entries + i * index_entry_ + sizeof(std::uint64_t)));
+        };
+        std::size_t low{0};
+        std::size_t high{count};
+
+        while (low < high) {
+            const auto mid = low + (high - low) / 2;
+
+            if (time(mid) <= fromNs) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+
+        if (0 < low) { start = std::max(start, offset(low - 1)); }
+
+        low = 0;
+        high = count;
+
+        while (low < high) {
+            const auto mid = low + (high - low) / 2;
+
+            if (time(mid) <= toNs) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+
+        if (low < count) { end = std::min(end, offset(low)); }
+    }
+
+    std::uint64_t matches{0};
+    std::string out{};
+    out.reserve(1 << 20);
+    auto position = start;
+
+    while (position + sizeof(std::uint32_t) <= end) {
+        const auto* record = data.data() + position;
+        const auto size = extract<std::uint32_t>(record);
+        record += sizeof(size);
+
+        if ((record_fixed_ > size) ||
+            (size > data.size() - position - sizeof(size))) {
+            std::cerr << "Truncated record at offset " << position << std::endl;
+
+            break;
+        }
+
+        position += sizeof(size) + size;
+        const auto received = extract<std::uint64_t>(record);
+        const auto recordLevel =
+            extract<std::int32_t>(record + sizeof(std::uint64_t));
+        const auto threadSize = extract<std::uint16_t>(
+            record + sizeof(std::uint64_t) + sizeof(std::int32_t));
+        const auto messageSize = extract<std::uint32_t>(
+            record + sizeof(std::uint64_t) + sizeof(std::int32_t) +
+            sizeof(std::uint16_t));
+
+        if (record_fixed_ + threadSize + messageSize != size) {
+            std::cerr << "Corrupt record before offset " << position
+                      << std::endl;
+
+            break;
+        }
+
+        if ((received < fromNs) || (received > toNs)) { continue; }
+
+        if (recordLevel > level) { continue; }
+
+        const auto* threadData =
+            reinterpret_cast<const char*>(record + record_fixed_);
+
+        if ((false == thread.empty()) &&
+            ((thread.size() != threadSize) ||
+             (0 != std::memcmp(thread.data(), threadData, threadSize)))) {
+            continue;
+        }
+
+        ++matches;
+
+        if (countOnly) { continue; }
+
+        format_time(out, received);
+        out.append(" [");
+        out.append(std::to_string(recordLevel));
+        out.append("] ");
+        out.append(threadData, threadSize);
+        out.append(": ");
+        out.append(threadData + threadSize, messageSize);
+        out.push_back('\n');
+
+        if (out.size() > (1 << 20)) {
+            std::cout << out;
+            out.clear();
+        }
+    }
+
+    std::cout << out;
+
+    if (countOnly) { std::cout << matches << std::endl; }
+
+    return 0;
+}
+
+void LogArchive::Write(
+    const std::int32_t level,
+    const std::string& message,
+    const std::string& thread)
+{
+    if (false == good_) { return; }
+
+    const auto received = static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch())
+            .count());
+    const auto threadSize = static_cast<std::uint16_t>(std::min<std::size_t>(
+        thread.size(), std::numeric_limits<std::uint16_t>::max()));
+    const auto messageSize = static_cast<std::uint32_t>(message.size());
+    std::string record{};
+    record.reserve(sizeof(std::uint32_t) + record_fixed_ + threadSize +
+                   messageSize);
+    append(
+        record,
+        static_cast<std::uint32_t>(record_fixed_ + threadSize + messageSize));
+    append(record, received);
+    append(record, level);
+    append(record, threadSize);
+    append(record, messageSize);
+    record.append(thread, 0, threadSize);
+    record.append(message);
+
+    data_ << record;
+
+    if (0 == count_ % LOG_INDEX_INTERVAL) {
+        std::string entry{};
+        append(entry, received);
+        append(entry, offset_);
+        data_.flush();
+        index_ << entry << std::flush;
+    }
+
+    offset_ += record.size();
+    ++count_;
+}
+
+LogArchive::~LogArchive()
+{
+    data_.flush();
+    index_.flush();
+}
+}  // namespace opentxs::otctl
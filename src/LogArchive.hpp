@@ -0,0 +1,49 @@
+// Copyright (c) 2019 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace opentxs::otctl
+{
+// Append-only binary capture of remote log frames
+//
+// The data file is a short header followed by length-prefixed records. Every
+// LOG_INDEX_INTERVAL records an entry (receive time, record offset) is appended
+// to a sidecar index file so queries can seek by time without a full scan.
+class LogArchive
+{
+public:
+    static int Query(const std::vector<std::string>& args);
+
+    LogArchive(const std::string& path);
+
+    bool good() const { return good_; }
+
+    void Write(
+        const std::int32_t level,
+        const std::string& message,
+        const std::string& thread);
+
+    ~LogArchive();
+
+private:
+    bool good_;
+    std::ofstream data_;
+    std::ofstream index_;
+    std::uint64_t offset_;
+    std::uint64_t count_;
+
+    LogArchive() = delete;
+    LogArchive(const LogArchive&) = delete;
+    LogArchive(LogArchive&&) = delete;
+    LogArchive& operator=(const LogArchive&) = delete;
+    LogArchive& operator=(LogArchive&&) = delete;
+};
+}  // namespace opentxs::otctl
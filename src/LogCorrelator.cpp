@@ -0,0 +1,67 @@
+// Copyright (c) 2019 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "LogCorrelator.hpp"
+
+#define LOG_CORRELATOR_DEPTH 100000
+
+namespace opentxs::otctl
+{
+LogCorrelator::LogCorrelator()
+    : lock_()
+    , next_(0)
+    , entries_()
+{
+}
+
+std::uint64_t LogCorrelator::Add(
+    const std::int32_t level,
+    const std::string& message,
+    const std::string& thread)
+{
+    Lock lock(lock_);
+    const auto position = next_.load();
+    entries_.push_back(
+        {position, std::chrono::system_clock::now(), level, thread, message});
+
+    if (LOG_CORRELATOR_DEPTH < entries_.size()) { entries_.pop_front(); }
+
+    // Incremented after the message is stored so a span closed at the old
+    // value never includes it
+    next_.store(position + 1);
+
+    return position;
+}
+
+std::vector<LogCorrelator::Entry> LogCorrelator::Excerpt(
+    const std::vector<RequestTracker::Span>& spans,
+    const std::vector<std::string>& ids) const
+{
+    std::vector<Entry> output{};
+    Lock lock(lock_);
+
+    for (const auto& entry : entries_) {
+        bool match{false};
+
+        for (const auto& span : spans) {
+            if ((entry.position_ >= span.begin_) &&
+                (entry.position_ < span.end_)) {
+                match = true;
+
+                break;
+            }
+        }
+
+        for (auto i = ids.cbegin(); (false == match) && (i != ids.cend());
+             ++i) {
+            match = (std::string::npos != entry.message_.find(*i));
+        }
+
+        if (match) { output.emplace_back(entry); }
+    }
+
+    return output;
+}
+}  // namespace opentxs::otctl
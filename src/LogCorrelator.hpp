@@ -0,0 +1,60 @@
+// Copyright (c) 2019 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "RequestTracker.hpp"
+
+namespace opentxs::otctl
+{
+// Bounded buffer of recent remote log messages in arrival order
+//
+// Each message is numbered; a message belongs to every command or task whose
+// RequestTracker span contains its number, or whose identifier it mentions.
+class LogCorrelator
+{
+public:
+    struct Entry {
+        std::uint64_t position_{0};
+        std::chrono::system_clock::time_point received_{};
+        std::int32_t level_{-1};
+        std::string thread_{};
+        std::string message_{};
+    };
+
+    // Number which will be assigned to the next message
+    std::uint64_t Position() const { return next_.load(); }
+
+    std::uint64_t Add(
+        const std::int32_t level,
+        const std::string& message,
+        const std::string& thread);
+    std::vector<Entry> Excerpt(
+        const std::vector<RequestTracker::Span>& spans,
+        const std::vector<std::string>& ids) const;
+
+    LogCorrelator();
+
+    ~LogCorrelator() = default;
+
+private:
+    mutable std::mutex lock_;
+    std::atomic<std::uint64_t> next_;
+    std::deque<Entry> entries_;
+
+    LogCorrelator(const LogCorrelator&) = delete;
+    LogCorrelator(LogCorrelator&&) = delete;
+    LogCorrelator& operator=(const LogCorrelator&) = delete;
+    LogCorrelator& operator=(LogCorrelator&&) = delete;
+};
+}  // namespace opentxs::otctl
@@ -0,0 +1,64 @@
+// Copyright (c) 2019 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "MappedFile.hpp"
+
+extern "C" {
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+}
+
+namespace opentxs::otctl
+{
+MappedFile::MappedFile(const std::string& path)
+    : good_(false)
+    , data_(nullptr)
+    , size_(0)
+{
+    const auto fd = ::open(path.c_str(), O_RDONLY);
+
+    if (0 > fd) { return; }
+
+    struct stat info {
+    };
+
+    if (0 != ::fstat(fd, &info)) {
+        ::close(fd);
+
+        return;
+    }
+
+    size_ = static_cast<std::size_t>(info.st_size);
+
+    if (0 == size_) {
+        ::close(fd);
+        good_ = true;
+
+        return;
+    }
+
+    auto* map = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+
+    if (MAP_FAILED == map) {
+        size_ = 0;
+
+        return;
+    }
+
+    ::madvise(map, size_, MADV_SEQUENTIAL);
+    data_ = static_cast<const std::uint8_t*>(map);
+    good_ = true;
+}
+
+MappedFile::~MappedFile()
+{
+    if (nullptr != data_) {
+        ::munmap(const_cast<std::uint8_t*>(data_), size_);
+    }
+}
+}  // namespace opentxs::otctl
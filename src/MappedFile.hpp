@@ -0,0 +1,38 @@
+// Copyright (c) 2019 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace opentxs::otctl
+{
+// Read-only memory mapping of an entire file
+class MappedFile
+{
+public:
+    explicit MappedFile(const std::string& path);
+
+    const std::uint8_t* data() const { return data_; }
+    bool empty() const { return 0 == size_; }
+    bool good() const { return good_; }
+    std::size_t size() const { return size_; }
+
+    ~MappedFile();
+
+private:
+    bool good_;
+    const std::uint8_t* data_;
+    std::size_t size_;
+
+    MappedFile() = delete;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile(MappedFile&&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile& operator=(MappedFile&&) = delete;
+};
+}  // namespace opentxs::otctl
@@ -0,0 +1,171 @@
+// Copyright (c) 2019 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "ObjectCache.hpp"
+
+#include <opentxs/opentxs.hpp>
+
+#include "Checksum.hpp"
+#include "MappedFile.hpp"
+
+#include <boost/filesystem.hpp>
+
+#include <cstring>
+
+#define OBJECT_CACHE_VERSION 1
+
+namespace fs = boost::filesystem;
+
+namespace
+{
+const char magic_[] = {'O', 'T', 'C', 'T', 'L', 'O', 'B', 'J'};
+constexpr std::size_t header_size_{sizeof(magic_) + sizeof(std::uint32_t)};
+// crc, type, id size, data size
+constexpr std::size_t record_fixed_{
+    sizeof(std::uint32_t) + sizeof(std::uint8_t) + sizeof(std::uint32_t) +
+    sizeof(std::uint32_t)};
+
+template <typename T>
+void append(std::string& out, const T value)
+{
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+T extract(const std::uint8_t* in)
+{
+    T output{};
+    std::memcpy(&output, in, sizeof(output));
+
+    return output;
+}
+}  // namespace
+
+namespace opentxs::otctl
+{
+ObjectCache::ObjectCache(const std::string& path)
+    : lock_()
+    , objects_()
+    , file_()
+{
+    // Never append to a file which belongs to something else
+    if (false == load(path)) { return; }
+
+    file_.open(path, std::ios::out | std::ios::binary | std::ios::app);
+
+    if (false == file_.good()) {
+        LogOutput(__FUNCTION__)(": Unable to open object cache ")(path)
+            .Flush();
+    }
+}
+
+bool ObjectCache::Get(
+    const Type type,
+    const std::string& id,
+    std::string& out) const
+{
+    Lock lock(lock_);
+    const auto it = objects_.find({type, id});
+
+    if (objects_.end() == it) { return false; }
+
+    out = it->second;
+
+    return true;
+}
+
+bool ObjectCache::load(const std::string& path)
+{
+    boost::system::error_code ec{};
+
+    if ((false == fs::exists(path, ec)) || (0 == fs::file_size(path, ec))) {
+        std::ofstream file(path, std::ios::out | std::ios::binary);
+        std::string header(magic_, sizeof(magic_));
+        append(header, std::uint32_t{OBJECT_CACHE_VERSION});
+        file << header;
+
+        return file.good();
+    }
+
+    std::size_t valid{0};
+
+    {
+        const MappedFile file(path);
+
+        if ((false == file.good()) || (header_size_ > file.size()) ||
+            (0 != std::memcmp(file.data(), magic_, sizeof(magic_)))) {
+            LogOutput(__FUNCTION__)(": ")(path)(" is not an object cache")
+                .Flush();
+
+            return false;
+        }
+
+        auto position = header_size_;
+        valid = position;
+
+        while (position + record_fixed_ <= file.size()) {
+            const auto* record = file.data() + position;
+            const auto crc = extract<std::uint32_t>(record);
+            const auto type = extract<std::uint8_t>(record + 4);
+            const auto idSize = extract<std::uint32_t>(record + 5);
+            const auto dataSize = extract<std::uint32_t>(record + 9);
+            const auto size =
+                record_fixed_ + std::size_t{idSize} + std::size_t{dataSize};
+
+            if (size > file.size() - position) { break; }
+
+            const auto* payload = record + sizeof(crc);
+
+            if (crc != crc32(payload, size - sizeof(crc))) { break; }
+
+            const auto* id = reinterpret_cast<const char*>(record) +
+                             record_fixed_;
+            objects_.emplace(
+                Key{static_cast<Type>(type), std::string(id, idSize)},
+                std::string(id + idSize, dataSize));
+            position += size;
+            valid = position;
+        }
+
+        if (valid == file.size()) { return true; }
+
+        LogOutput(__FUNCTION__)(": Discarding ")(file.size() - valid)(
+            " corrupt bytes from ")(path)
+            .Flush();
+    }
+
+    // Later appends must not land behind an unreadable record
+    fs::resize_file(path, valid, ec);
+
+    return true;
+}
+
+void ObjectCache::Put(
+    const Type type,
+    const std::string& id,
+    const std::string& data)
+{
+    Lock lock(lock_);
+
+    if (false == objects_.emplace(Key{type, id}, data).second) { return; }
+
+    if (false == file_.good()) { return; }
+
+    std::string record{};
+    record.reserve(record_fixed_ + id.size() + data.size());
+    append(record, std::uint32_t{0});
+    append(record, static_cast<std::uint8_t>(type));
+    append(record, static_cast<std::uint32_t>(id.size()));
+    append(record, static_cast<std::uint32_t>(data.size()));
+    record.append(id);
+    record.append(data);
+    const auto crc =
+        crc32(record.data() + sizeof(std::uint32_t), record.size() - 4);
+    std::memcpy(&record[0], &crc, sizeof(crc));
+    file_ << record << std::flush;
+}
+
+ObjectCache::~ObjectCache() { file_.flush(); }
+}  // namespace opentxs::otctl
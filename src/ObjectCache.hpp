@@ -0,0 +1,53 @@
+// Copyright (c) 2019 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+
+namespace opentxs::otctl
+{
+// Persistent cache of serialized immutable contracts, keyed by ID
+//
+// The backing file is append-only. Every record carries a CRC32 and records
+// which fail it, along with anything after them, are ignored when loading.
+class ObjectCache
+{
+public:
+    enum class Type : std::uint8_t {
+        Nym = 1,
+        Server = 2,
+        Unit = 3,
+    };
+
+    bool Get(const Type type, const std::string& id, std::string& out) const;
+    void Put(const Type type, const std::string& id, const std::string& data);
+
+    ObjectCache(const std::string& path);
+
+    ~ObjectCache();
+
+private:
+    using Key = std::pair<Type, std::string>;
+
+    mutable std::mutex lock_;
+    std::map<Key, std::string> objects_;
+    std::ofstream file_;
+
+    // Returns false unless the file holds, or was created as, an object cache
+    bool load(const std::string& path);
+
+    ObjectCache() = delete;
+    ObjectCache(const ObjectCache&) = delete;
+    ObjectCache(ObjectCache&&) = delete;
+    ObjectCache& operator=(const ObjectCache&) = delete;
+    ObjectCache& operator=(ObjectCache&&) = delete;
+};
+}  // namespace opentxs::otctl
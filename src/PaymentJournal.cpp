@@ -0,0 +1,255 @@
+// Copyright (c) 2019 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "PaymentJournal.hpp"
+
+#include <opentxs/opentxs.hpp>
+
+#include "Checksum.hpp"
+#include "MappedFile.hpp"
+
+#include <boost/filesystem.hpp>
+
+#include <cerrno>
+#include <cstring>
+
+extern "C" {
+#include <fcntl.h>
+#include <unistd.h>
+}
+
+#define PAYMENT_JOURNAL_VERSION 1
+
+namespace fs = boost::filesystem;
+
+namespace
+{
+const char magic_[] = {'O', 'T', 'C', 'T', 'L', 'P', 'A', 'Y'};
+constexpr std::size_t header_size_{sizeof(magic_) + sizeof(std::uint32_t)};
+// crc, stage, row, value, text size
+constexpr std::size_t record_fixed_{
+    sizeof(std::uint32_t) + sizeof(std::uint8_t) + sizeof(std::uint64_t) +
+    sizeof(std::int32_t) + sizeof(std::uint32_t)};
+
+template <typename T>
+void append(std::string& out, const T value)
+{
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+T extract(const std::uint8_t* in)
+{
+    T output{};
+    std::memcpy(&output, in, sizeof(output));
+
+    return output;
+}
+
+bool write_all(const int fd, const std::string& bytes)
+{
+    std::size_t written{0};
+
+    while (written < bytes.size()) {
+        const auto result =
+            ::write(fd, bytes.data() + written, bytes.size() - written);
+
+        if (0 > result) {
+            if (EINTR == errno) { continue; }
+
+            return false;
+        }
+
+        written += static_cast<std::size_t>(result);
+    }
+
+    return true;
+}
+}  // namespace
+
+namespace opentxs::otctl
+{
+PaymentJournal::PaymentJournal(const std::string& path)
+    : lock_()
+    , entries_()
+    , fd_(-1)
+{
+    boost::system::error_code ec{};
+    const auto exists =
+        fs::exists(path, ec) && (0 < fs::file_size(path, ec));
+
+    if (exists) {
+        std::size_t valid{0};
+        std::size_t size{0};
+
+        {
+            const MappedFile file(path);
+            size = file.size();
+
+            if ((false == file.good()) || (header_size_ > file.size()) ||
+                (0 != std::memcmp(file.data(), magic_, sizeof(magic_)))) {
+                LogOutput(__FUNCTION__)(": ")(path)(" is not a payment journal")
+                    .Flush();
+
+                return;
+            }
+
+            auto position = header_size_;
+            valid = position;
+
+            while (position + record_fixed_ <= file.size()) {
+                const auto* record = file.data() + position;
+                const auto crc = extract<std::uint32_t>(record);
+                const auto stage = extract<std::uint8_t>(record + 4);
+                const auto row = extract<std::uint64_t>(record + 5);
+                const auto value = extract<std::int32_t>(record + 13);
+                const auto textSize = extract<std::uint32_t>(record + 17);
+                const auto bytes = record_fixed_ + std::size_t{textSize};
+
+                if (bytes > file.size() - position) { break; }
+
+                if (crc != crc32(record + sizeof(crc), bytes - sizeof(crc))) {
+                    break;
+                }
+
+                apply(
+                    static_cast<Stage>(stage),
+                    row,
+                    value,
+                    std::string(
+                        reinterpret_cast<const char*>(record) + record_fixed_,
+                        textSize));
+                position += bytes;
+                valid = position;
+            }
+        }
+
+        if (valid != size) {
+            LogOutput(__FUNCTION__)(": Discarding ")(size - valid)(
+                " corrupt bytes from ")(path)
+                .Flush();
+            // Later appends must not land behind an unreadable record
+            fs::resize_file(path, valid, ec);
+        }
+    }
+
+    fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0600);
+
+    if (-1 == fd_) {
+        LogOutput(__FUNCTION__)(": Unable to open payment journal ")(path)
+            .Flush();
+
+        return;
+    }
+
+    if (exists) { return; }
+
+    std::string header(magic_, sizeof(magic_));
+    append(header, std::uint32_t{PAYMENT_JOURNAL_VERSION});
+
+    if ((false == write_all(fd_, header)) || (0 != ::fdatasync(fd_))) {
+        LogOutput(__FUNCTION__)(": Unable to write ")(path).Flush();
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+void PaymentJournal::apply(
+    const Stage stage,
+    const std::uint64_t row,
+    const std::int32_t value,
+    const std::string& text)
+{
+    auto& entry = entries_[row];
+
+    switch (stage) {
+        case Stage::Intent: {
+            // A resent row starts over
+            entry = Entry{};
+            entry.checksum_ = static_cast<std::uint32_t>(value);
+            entry.cookie_ = text;
+        } break;
+        case Stage::Reply: {
+            entry.replied_ = true;
+            entry.status_ = value;
+            entry.task_ = text;
+        } break;
+        case Stage::Result: {
+            entry.finished_ = true;
+            entry.success_ = (0 != value);
+        } break;
+        default: {
+        }
+    }
+}
+
+bool PaymentJournal::Intent(
+    const std::uint64_t row,
+    const std::uint32_t checksum,
+    const std::string& cookie)
+{
+    return write(
+        Stage::Intent, row, static_cast<std::int32_t>(checksum), cookie, true);
+}
+
+void PaymentJournal::Reply(
+    const std::uint64_t row,
+    const int status,
+    const std::string& task)
+{
+    write(Stage::Reply, row, status, task, false);
+}
+
+void PaymentJournal::Result(const std::uint64_t row, const bool success)
+{
+    write(Stage::Result, row, success ? 1 : 0, "", false);
+}
+
+bool PaymentJournal::write(
+    const Stage stage,
+    const std::uint64_t row,
+    const std::int32_t value,
+    const std::string& text,
+    const bool sync)
+{
+    std::string record{};
+    record.reserve(record_fixed_ + text.size());
+    append(record, std::uint32_t{0});
+    append(record, static_cast<std::uint8_t>(stage));
+    append(record, row);
+    append(record, value);
+    append(record, static_cast<std::uint32_t>(text.size()));
+    record.append(text);
+    const auto crc =
+        crc32(record.data() + sizeof(std::uint32_t), record.size() - 4);
+    std::memcpy(&record[0], &crc, sizeof(crc));
+    Lock lock(lock_);
+
+    if (-1 == fd_) { return false; }
+
+    if (false == write_all(fd_, record)) {
+        LogOutput(__FUNCTION__)(": Unable to append to payment journal")
+            .Flush();
+
+        return false;
+    }
+
+    if (sync && (0 != ::fdatasync(fd_))) {
+        LogOutput(__FUNCTION__)(": Unable to sync payment journal").Flush();
+
+        return false;
+    }
+
+    return true;
+}
+
+PaymentJournal::~PaymentJournal()
+{
+    if (-1 == fd_) { return; }
+
+    ::fdatasync(fd_);
+    ::close(fd_);
+}
+}  // namespace opentxs::otctl
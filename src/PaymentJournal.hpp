@@ -0,0 +1,83 @@
+// Copyright (c) 2019 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace opentxs::otctl
+{
+// Write-ahead journal for bulk payments
+//
+// The intent to send a row is synced to disk before the command leaves, so
+// after a crash every row which might have reached otagent is known. Replies
+// and task results are appended as they arrive without syncing: losing them
+// only leaves a row in the unknown state, never makes it look unsent.
+class PaymentJournal
+{
+public:
+    struct Entry {
+        // Checksum of the source row, to detect an edited input file
+        std::uint32_t checksum_{0};
+        std::string cookie_{};
+        bool replied_{false};
+        int status_{0};
+        std::string task_{};
+        bool finished_{false};
+        bool success_{false};
+    };
+
+    // State recovered from the file when the journal was opened
+    const std::map<std::uint64_t, Entry>& Entries() const { return entries_; }
+    bool good() const { return -1 != fd_; }
+
+    // Returns false unless the record is durable
+    bool Intent(
+        const std::uint64_t row,
+        const std::uint32_t checksum,
+        const std::string& cookie);
+    void Reply(
+        const std::uint64_t row,
+        const int status,
+        const std::string& task);
+    void Result(const std::uint64_t row, const bool success);
+
+    explicit PaymentJournal(const std::string& path);
+
+    ~PaymentJournal();
+
+private:
+    enum class Stage : std::uint8_t {
+        Intent = 0,
+        Reply = 1,
+        Result = 2,
+    };
+
+    std::mutex lock_;
+    std::map<std::uint64_t, Entry> entries_;
+    int fd_;
+
+    void apply(
+        const Stage stage,
+        const std::uint64_t row,
+        const std::int32_t value,
+        const std::string& text);
+    bool write(
+        const Stage stage,
+        const std::uint64_t row,
+        const std::int32_t value,
+        const std::string& text,
+        const bool sync);
+
+    PaymentJournal() = delete;
+    PaymentJournal(const PaymentJournal&) = delete;
+    PaymentJournal(PaymentJournal&&) = delete;
+    PaymentJournal& operator=(const PaymentJournal&) = delete;
+    PaymentJournal& operator=(PaymentJournal&&) = delete;
+};
+}  // namespace opentxs::otctl
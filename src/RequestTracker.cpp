@@ -0,0 +1,269 @@
+// Copyright (c) 2019 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "RequestTracker.hpp"
+
+#include <algorithm>
+
+#define TRACKER_EXPIRY_SECONDS 3600
+#define TRACKER_OUTSTANDING_REQUESTS 65536
+#define TRACKER_RECENT_REQUESTS 4096
+
+namespace opentxs::otctl
+{
+RequestTracker::RequestTracker()
+    : lock_()
+    , records_()
+    , tasks_()
+    , pending_()
+    , running_()
+    , finished_()
+    , sent_()
+    , early_()
+    , arrived_()
+{
+}
+
+void RequestTracker::check_finished(
+    const std::string& cookie,
+    Record& record)
+{
+    if (false == record.replied_) { return; }
+
+    for (const auto& [task, span] : record.tasks_) {
+        if (std::numeric_limits<std::uint64_t>::max() == span.end_) {
+            return;
+        }
+    }
+
+    record.finished_ = true;
+    finished_.push_back(cookie);
+
+    while (TRACKER_RECENT_REQUESTS < finished_.size()) {
+        const auto it = records_.find(finished_.front());
+
+        if (records_.end() != it) {
+            for (const auto& task : it->second.tasks_) {
+                tasks_.erase(task.first);
+            }
+
+            records_.erase(it);
+        }
+
+        finished_.pop_front();
+    }
+}
+
+// Drops the oldest outstanding commands while they are too old or too many.
+// Finished commands are skipped here since finished_ bounds those.
+void RequestTracker::expire(const Clock::time_point now)
+{
+    const auto limit = now - std::chrono::seconds(TRACKER_EXPIRY_SECONDS);
+
+    while (false == sent_.empty()) {
+        const auto it = records_.find(sent_.front());
+
+        if ((records_.end() == it) || it->second.finished_) {
+            sent_.pop_front();
+
+            continue;
+        }
+
+        const auto outstanding = records_.size() - finished_.size();
+
+        if ((it->second.sent_ > limit) &&
+            (TRACKER_OUTSTANDING_REQUESTS >= outstanding)) {
+            break;
+        }
+
+        for (const auto& task : it->second.tasks_) {
+            running_.erase(task.first);
+            tasks_.erase(task.first);
+        }
+
+        pending_.erase(it->first);
+        records_.erase(it);
+        sent_.pop_front();
+    }
+}
+
+std::vector<std::string> RequestTracker::Outstanding() const
+{
+    Lock lock(lock_);
+    std::vector<std::string> output{pending_.begin(), pending_.end()};
+    output.insert(output.end(), running_.begin(), running_.end());
+
+    return output;
+}
+
+std::vector<RequestTracker::Summary> RequestTracker::Recent() const
+{
+    Lock lock(lock_);
+    std::vector<std::pair<Clock::time_point, Summary>> sorted{};
+
+    for (const auto& [cookie, record] : records_) {
+        Summary summary{cookie, record.type_, record.replied_, {}};
+
+        for (const auto& task : record.tasks_) {
+            summary.tasks_.emplace_back(task.first);
+        }
+
+        sorted.emplace_back(record.sent_, std::move(summary));
+    }
+
+    std::sort(
+        sorted.begin(), sorted.end(), [](const auto& lhs, const auto& rhs) {
+            return lhs.first < rhs.first;
+        });
+    std::vector<Summary> output{};
+    output.reserve(sorted.size());
+
+    for (auto& item : sorted) { output.emplace_back(std::move(item.second)); }
+
+    return output;
+}
+
+RequestTracker::ReplyCallback RequestTracker::Replied(
+    const proto::RPCResponse& in,
+    const std::uint64_t position)
+{
+    Lock lock(lock_);
+    const auto& cookie = in.cookie();
+    auto it = records_.find(cookie);
+
+    if ((records_.end() == it) || it->second.replied_) { return {}; }
+
+    auto& record = it->second;
+    auto output = std::move(record.callback_);
+    record.callback_ = {};
+    record.replied_ = true;
+    record.span_.end_ = position;
+    pending_.erase(cookie);
+    std::vector<std::pair<std::string, bool>> completed{};
+
+    for (const auto& status : in.status()) {
+        const auto index = static_cast<int>(status.index());
+
+        if ((proto::RPCRESPONSE_QUEUED != status.code()) ||
+            (index >= in.task_size())) {
+            continue;
+        }
+
+        const auto& task = in.task(index).id();
+        auto& span = record.tasks_[task];
+        span.begin_ = record.span_.begin_;
+        tasks_[task] = cookie;
+        const auto early = early_.find(task);
+
+        if (early_.end() == early) {
+            running_.insert(task);
+        } else {
+            span.end_ = early->second.position_;
+            completed.emplace_back(task, early->second.success_);
+            early_.erase(early);
+        }
+    }
+
+    check_finished(cookie, record);
+
+    if (completed.empty() || (false == bool(record.task_callback_))) {
+        return output;
+    }
+
+    return [reply = std::move(output),
+            task = record.task_callback_,
+            completed](const proto::RPCResponse& response) {
+        if (reply) { reply(response); }
+
+        for (const auto& [id, success] : completed) { task(id, success); }
+    };
+}
+
+void RequestTracker::Sent(
+    const proto::RPCCommand& in,
+    const std::uint64_t position,
+    ReplyCallback callback,
+    TaskCallback task)
+{
+    Lock lock(lock_);
+    const auto now = Clock::now();
+    expire(now);
+    auto& record = records_[in.cookie()];
+    record.type_ = in.type();
+    record.sent_ = now;
+    record.span_.begin_ = position;
+    record.callback_ = std::move(callback);
+    record.task_callback_ = std::move(task);
+    pending_.insert(in.cookie());
+    sent_.push_back(in.cookie());
+}
+
+bool RequestTracker::Spans(
+    const std::string& id,
+    std::vector<Span>& spans,
+    std::vector<std::string>& ids) const
+{
+    Lock lock(lock_);
+    const auto record = records_.find(id);
+
+    if (records_.end() != record) {
+        spans.emplace_back(record->second.span_);
+        ids.emplace_back(id);
+
+        for (const auto& [task, span] : record->second.tasks_) {
+            spans.emplace_back(span);
+            ids.emplace_back(task);
+        }
+
+        return true;
+    }
+
+    const auto task = tasks_.find(id);
+
+    if (tasks_.end() == task) { return false; }
+
+    spans.emplace_back(records_.at(task->second).tasks_.at(id));
+    ids.emplace_back(id);
+
+    return true;
+}
+
+RequestTracker::TaskCallback RequestTracker::TaskComplete(
+    const std::string& task,
+    const std::uint64_t position,
+    const bool success)
+{
+    Lock lock(lock_);
+    const auto it = tasks_.find(task);
+
+    if (tasks_.end() == it) {
+        // A push notification can overtake the reply which announced the task
+        if (early_.emplace(task, Early{position, success}).second) {
+            arrived_.push_back(task);
+        }
+
+        // Entries claimed by Replied() stay queued until they reach the
+        // front, so the queue bounds both containers
+        while (TRACKER_RECENT_REQUESTS < arrived_.size()) {
+            early_.erase(arrived_.front());
+            arrived_.pop_front();
+        }
+
+        return {};
+    }
+
+    auto& record = records_.at(it->second);
+    auto& span = record.tasks_.at(task);
+
+    if (std::numeric_limits<std::uint64_t>::max() != span.end_) { return {}; }
+
+    span.end_ = position;
+    running_.erase(task);
+    auto output = record.task_callback_;
+    check_finished(it->second, record);
+
+    return output;
+}
+}  // namespace opentxs::otctl
@@ -0,0 +1,118 @@
+// Copyright (c) 2019 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <opentxs/opentxs.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace opentxs::otctl
+{
+// Lifetime of every command cookie and queued task
+//
+// Positions are sequence numbers supplied by the caller (see LogCorrelator) so
+// that anything which happened while a command or task was outstanding can be
+// attributed to it.
+//
+// Commands which never receive a reply, or whose tasks never complete, are
+// forgotten after an hour or once too many commands are outstanding.
+class RequestTracker
+{
+public:
+    using Clock = std::chrono::steady_clock;
+    using ReplyCallback = std::function<void(const proto::RPCResponse&)>;
+    using TaskCallback =
+        std::function<void(const std::string& task, const bool success)>;
+
+    struct Span {
+        std::uint64_t begin_{0};
+        std::uint64_t end_{std::numeric_limits<std::uint64_t>::max()};
+    };
+
+    struct Summary {
+        std::string cookie_{};
+        proto::RPCCommandType type_{};
+        bool replied_{false};
+        std::vector<std::string> tasks_{};
+    };
+
+    // Cookies awaiting a reply followed by task IDs awaiting completion
+    std::vector<std::string> Outstanding() const;
+    // Outstanding and recently finished commands, oldest first
+    std::vector<Summary> Recent() const;
+    // Spans and identifiers belonging to a cookie or a task ID
+    bool Spans(
+        const std::string& id,
+        std::vector<Span>& spans,
+        std::vector<std::string>& ids) const;
+
+    // Returns the callback registered for the cookie, if any. When tasks
+    // announced by the reply have already completed, the returned callback
+    // also runs the task callback for each of them.
+    ReplyCallback Replied(
+        const proto::RPCResponse& in,
+        const std::uint64_t position);
+    // The task callback runs once for every task queued by the command
+    void Sent(
+        const proto::RPCCommand& in,
+        const std::uint64_t position,
+        ReplyCallback callback = {},
+        TaskCallback task = {});
+    // Returns the task callback of the command which queued the task, if any
+    TaskCallback TaskComplete(
+        const std::string& task,
+        const std::uint64_t position,
+        const bool success);
+
+    RequestTracker();
+
+    ~RequestTracker() = default;
+
+private:
+    struct Record {
+        proto::RPCCommandType type_{};
+        Clock::time_point sent_{};
+        Span span_{};
+        bool replied_{false};
+        std::map<std::string, Span> tasks_{};
+        ReplyCallback callback_{};
+        TaskCallback task_callback_{};
+        bool finished_{false};
+    };
+
+    struct Early {
+        std::uint64_t position_{0};
+        bool success_{false};
+    };
+
+    mutable std::mutex lock_;
+    std::map<std::string, Record> records_;
+    std::map<std::string, std::string> tasks_;
+    std::set<std::string> pending_;
+    std::set<std::string> running_;
+    std::deque<std::string> finished_;
+    std::deque<std::string> sent_;
+    std::map<std::string, Early> early_;
+    std::deque<std::string> arrived_;
+
+    void check_finished(const std::string& cookie, Record& record);
+    void expire(const Clock::time_point now);
+
+    RequestTracker(const RequestTracker&) = delete;
+    RequestTracker(RequestTracker&&) = delete;
+    RequestTracker& operator=(const RequestTracker&) = delete;
+    RequestTracker& operator=(RequestTracker&&) = delete;
+};
+}  // namespace opentxs::otctl
@@ -0,0 +1,73 @@
+// Copyright (c) 2019 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "Scheduler.hpp"
+
+namespace opentxs::otctl
+{
+Scheduler::Scheduler()
+    : lock_()
+    , cv_()
+    , jobs_()
+    , shutdown_(false)
+    , thread_(&Scheduler::run, this)
+{
+}
+
+void Scheduler::At(const Clock::time_point when, Job job)
+{
+    {
+        std::unique_lock<std::mutex> lock(lock_);
+
+        if (shutdown_) { return; }
+
+        jobs_.emplace(when, std::move(job));
+    }
+
+    cv_.notify_all();
+}
+
+void Scheduler::run()
+{
+    std::unique_lock<std::mutex> lock(lock_);
+
+    while (false == shutdown_) {
+        if (jobs_.empty()) {
+            cv_.wait(lock);
+
+            continue;
+        }
+
+        const auto next = jobs_.begin()->first;
+
+        if (Clock::now() < next) {
+            cv_.wait_until(lock, next);
+
+            continue;
+        }
+
+        auto job = std::move(jobs_.begin()->second);
+        jobs_.erase(jobs_.begin());
+        lock.unlock();
+        job();
+        lock.lock();
+    }
+}
+
+void Scheduler::Stop()
+{
+    {
+        std::unique_lock<std::mutex> lock(lock_);
+        shutdown_ = true;
+        jobs_.clear();
+    }
+
+    cv_.notify_all();
+
+    if (thread_.joinable()) { thread_.join(); }
+}
+
+Scheduler::~Scheduler() { Stop(); }
+}  // namespace opentxs::otctl
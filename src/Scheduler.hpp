@@ -0,0 +1,47 @@
+// Copyright (c) 2019 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace opentxs::otctl
+{
+// Runs jobs at a later time on a single background thread
+class Scheduler
+{
+public:
+    using Clock = std::chrono::steady_clock;
+    using Job = std::function<void()>;
+
+    // Ignored once the scheduler has been stopped
+    void At(const Clock::time_point when, Job job);
+    // Discards pending jobs and waits for a running one to return
+    void Stop();
+
+    Scheduler();
+
+    ~Scheduler();
+
+private:
+    std::mutex lock_;
+    std::condition_variable cv_;
+    std::multimap<Clock::time_point, Job> jobs_;
+    bool shutdown_;
+    std::thread thread_;
+
+    void run();
+
+    Scheduler(const Scheduler&) = delete;
+    Scheduler(Scheduler&&) = delete;
+    Scheduler& operator=(const Scheduler&) = delete;
+    Scheduler& operator=(Scheduler&&) = delete;
+};
+}  // namespace opentxs::otctl
@@ -0,0 +1,363 @@
+// Copyright (c) 2019 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "Snapshot.hpp"
+
+#include <opentxs/opentxs.hpp>
+
+#include <boost/program_options.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <tuple>
+
+#if __has_include("json/json.h")
+#include <json/json.h>
+#elif __has_include("jsoncpp/json/json.h")
+#include <jsoncpp/json/json.h>
+#endif
+
+#define SNAPSHOT_VERSION 1
+
+namespace po = boost::program_options;
+
+namespace
+{
+// Reads one object per call so that neither snapshot is held in memory
+class Reader
+{
+public:
+    Json::Value object_;
+    std::string kind_;
+    std::string id_;
+
+    bool good() const { return good_; }
+    bool done() const { return done_; }
+
+    // Moves to the next object. Returns false at the end or on error.
+    bool Next()
+    {
+        std::string line{};
+
+        while (std::getline(file_, line)) {
+            ++line_;
+
+            if (line.empty()) { continue; }
+
+            std::string error{};
+            object_ = Json::Value{};
+            const auto parsed = reader_->parse(
+                line.data(), line.data() + line.size(), &object_, &error);
+
+            if ((false == parsed) || (false == object_.isObject())) {
+                std::cerr << path_ << ":" << line_ << ": " << error
+                          << std::endl;
+                good_ = false;
+
+                break;
+            }
+
+            if (object_.isMember("snapshot")) { continue; }
+
+            const auto kind = object_["kind"].asString();
+            const auto id = object_["id"].asString();
+
+            // The merge is only correct if both inputs are sorted
+            if (std::tie(kind, id) < std::tie(kind_, id_)) {
+                std::cerr << path_ << ":" << line_ << ": Not sorted"
+                          << std::endl;
+                good_ = false;
+
+                break;
+            }
+
+            kind_ = kind;
+            id_ = id;
+
+            return true;
+        }
+
+        done_ = true;
+
+        return false;
+    }
+
+    explicit Reader(const std::string& path)
+        : object_()
+        , kind_()
+        , id_()
+        , path_(path)
+        , file_(path)
+        , reader_(Json::CharReaderBuilder{}.newCharReader())
+        , line_(0)
+        , good_(file_.good())
+        , done_(false)
+    {
+        if (false == good_) { std::cerr << "Unable to read " << path << "\n"; }
+    }
+
+private:
+    const std::string path_;
+    std::ifstream file_;
+    std::unique_ptr<Json::CharReader> reader_;
+    std::size_t line_;
+    bool good_;
+    bool done_;
+};
+
+// Negative if the old snapshot is behind, positive if the new one is behind
+int compare_position(const Reader& before, const Reader& after)
+{
+    if (before.done()) { return 1; }
+
+    if (after.done()) { return -1; }
+
+    const auto kind = before.kind_.compare(after.kind_);
+
+    return (0 == kind) ? before.id_.compare(after.id_) : kind;
+}
+
+std::unique_ptr<Json::StreamWriter> compact_writer()
+{
+    Json::StreamWriterBuilder builder{};
+    builder["indentation"] = "";
+
+    return std::unique_ptr<Json::StreamWriter>(builder.newStreamWriter());
+}
+}  // namespace
+
+namespace opentxs::otctl
+{
+int Snapshot::Diff(const std::vector<std::string>& args)
+{
+    std::vector<std::string> files{};
+    bool summary{false};
+
+    po::options_description options("diff");
+    options.add_options()(
+        "file", po::value<std::vector<std::string>>(&files), "<old> <new>")(
+        "summary", po::bool_switch(&summary), "only print totals per kind");
+    po::positional_options_description positional{};
+    positional.add("file", 2);
+
+    try {
+        po::variables_map variables{};
+        po::store(
+            po::command_line_parser(args)
+                .options(options)
+                .positional(positional)
+                .run(),
+            variables);
+        po::notify(variables);
+    } catch (const po::error& e) {
+        std::cerr << "ERROR: " << e.what() << "\n\n" << options << std::endl;
+
+        return 2;
+    }
+
+    if (2 != files.size()) {
+        std::cerr << options << std::endl;
+
+        return 2;
+    }
+
+    struct Totals {
+        std::size_t added_{0};
+        std::size_t removed_{0};
+        std::size_t changed_{0};
+        std::int64_t balance_{0};
+    };
+
+    Reader before(files.at(0));
+    Reader after(files.at(1));
+
+    if ((false == before.good()) || (false == after.good())) { return 2; }
+
+    std::map<std::string, Totals> totals{};
+    std::string out{};
+    const auto line = [&](const char prefix, const Reader& reader) {
+        if (summary) { return; }
+
+        out.push_back(prefix);
+        out.push_back(' ');
+        out.append(reader.kind_);
+        out.push_back(' ');
+        out.append(reader.id_);
+        out.push_back('\n');
+    };
+    const auto flush = [&]() {
+        if (out.size() > (1 << 20)) {
+            std::cout << out;
+            out.clear();
+        }
+    };
+    const auto compare = [&]() {
+        const auto& lhs = before.object_;
+        const auto& rhs = after.object_;
+        auto& total = totals[after.kind_];
+        bool changed{false};
+        std::string fields{};
+
+        for (const auto& name : rhs.getMemberNames()) {
+            if (lhs.isMember(name) && (lhs[name] == rhs[name])) { continue; }
+
+            changed = true;
+
+            if (summary) { continue; }
+
+            fields.append("    ");
+            fields.append(name);
+            fields.append(": ");
+            fields.append(lhs.get(name, "").asString());
+            fields.append(" -> ");
+            fields.append(rhs[name].asString());
+
+            if (("balance" == name) || ("pending" == name)) {
+                const auto delta = rhs[name].asInt64() - lhs[name].asInt64();
+                fields.append(" (");
+                fields.append((0 < delta) ? "+" : "");
+                fields.append(std::to_string(delta));
+                fields.append(")");
+            }
+
+            fields.push_back('\n');
+        }
+
+        for (const auto& name : lhs.getMemberNames()) {
+            if (rhs.isMember(name)) { continue; }
+
+            changed = true;
+
+            if (summary) { continue; }
+
+            fields.append("    ");
+            fields.append(name);
+            fields.append(": ");
+            fields.append(lhs[name].asString());
+            fields.append(" -> \n");
+        }
+
+        if (false == changed) { return; }
+
+        ++total.changed_;
+        total.balance_ +=
+            rhs.get("balance", 0).asInt64() - lhs.get("balance", 0).asInt64();
+        line('~', after);
+        out.append(fields);
+    };
+
+    before.Next();
+    after.Next();
+
+    while ((false == before.done()) || (false == after.done())) {
+        if ((false == before.good()) || (false == after.good())) { return 2; }
+
+        const auto order = compare_position(before, after);
+
+        if (0 > order) {
+            auto& total = totals[before.kind_];
+            ++total.removed_;
+            total.balance_ -= before.object_.get("balance", 0).asInt64();
+            line('-', before);
+            before.Next();
+        } else if (0 < order) {
+            auto& total = totals[after.kind_];
+            ++total.added_;
+            total.balance_ += after.object_.get("balance", 0).asInt64();
+            line('+', after);
+            after.Next();
+        } else {
+            compare();
+            before.Next();
+            after.Next();
+        }
+
+        flush();
+    }
+
+    if ((false == before.good()) || (false == after.good())) { return 2; }
+
+    bool different{false};
+
+    for (const auto& [kind, total] : totals) {
+        if (0 == total.added_ + total.removed_ + total.changed_) { continue; }
+
+        different = true;
+        out.append(kind);
+        out.append(": ");
+        out.append(std::to_string(total.added_));
+        out.append(" added, ");
+        out.append(std::to_string(total.removed_));
+        out.append(" removed, ");
+        out.append(std::to_string(total.changed_));
+        out.append(" changed");
+
+        if ("account" == kind) {
+            out.append(", balance ");
+            out.append((0 < total.balance_) ? "+" : "");
+            out.append(std::to_string(total.balance_));
+        }
+
+        out.push_back('\n');
+    }
+
+    std::cout << out << std::flush;
+
+    return different ? 1 : 0;
+}
+
+bool Snapshot::Write(
+    const std::string& path,
+    const Info& info,
+    std::vector<Record>& records)
+{
+    std::sort(
+        records.begin(), records.end(), [](const auto& lhs, const auto& rhs) {
+            return std::tie(lhs.kind_, lhs.id_) < std::tie(rhs.kind_, rhs.id_);
+        });
+    const auto writer = compact_writer();
+    std::ofstream file(path, std::ios::out | std::ios::trunc);
+    Json::Value header{Json::objectValue};
+    header["snapshot"] = SNAPSHOT_VERSION;
+    header["instance"] = info.instance_;
+    header["endpoint"] = info.endpoint_;
+    header["created"] = Json::Int64{info.created_};
+    header["elapsed_ms"] = Json::Int64{info.elapsed_ms_};
+    header["counts"] = Json::Value{Json::objectValue};
+
+    for (const auto& record : records) {
+        auto& count = header["counts"][record.kind_];
+        count = count.asUInt64() + 1;
+    }
+
+    writer->write(header, &file);
+    file << '\n';
+
+    for (const auto& record : records) {
+        Json::Value line{Json::objectValue};
+        line["kind"] = record.kind_;
+        line["id"] = record.id_;
+
+        for (const auto& [key, value] : record.text_) { line[key] = value; }
+
+        for (const auto& [key, value] : record.numbers_) {
+            line[key] = Json::Int64{value};
+        }
+
+        writer->write(line, &file);
+        file << '\n';
+    }
+
+    if (false == file.good()) {
+        LogOutput(__FUNCTION__)(": Unable to write ")(path).Flush();
+
+        return false;
+    }
+
+    return true;
+}
+}  // namespace opentxs::otctl
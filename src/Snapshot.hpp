@@ -0,0 +1,49 @@
+// Copyright (c) 2019 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace opentxs::otctl
+{
+// Wallet snapshot files
+//
+// A snapshot is newline delimited JSON. The first line describes the snapshot
+// itself, every following line is one object sorted by kind and then by id,
+// so two snapshots can be compared line by line in a single pass.
+class Snapshot
+{
+public:
+    struct Record {
+        // account, contact, nym, seed, server or unit
+        std::string kind_{};
+        std::string id_{};
+        std::map<std::string, std::string> text_{};
+        std::map<std::string, std::int64_t> numbers_{};
+    };
+
+    struct Info {
+        int instance_{-1};
+        std::string endpoint_{};
+        // Unix time at which collection started
+        std::int64_t created_{0};
+        std::int64_t elapsed_ms_{0};
+    };
+
+    // otctl diff <old> <new>: streams both snapshots and prints objects which
+    // were added, removed or changed. Returns 0 if the snapshots hold the same
+    // objects, 1 if they differ and 2 on error, like diff(1).
+    static int Diff(const std::vector<std::string>& args);
+    // Sorts the records and writes them after a header line built from info
+    static bool Write(
+        const std::string& path,
+        const Info& info,
+        std::vector<Record>& records);
+};
+}  // namespace opentxs::otctl
@@ -0,0 +1,174 @@
+// Copyright (c) 2019 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "Tracer.hpp"
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <iomanip>
+#include <sstream>
+
+#define TRACE_CATEGORY "otctl"
+
+namespace opentxs::otctl
+{
+Tracer::Tracer(const std::string& path)
+    : start_(Clock::now())
+    , pid_(static_cast<int>(::getpid()))
+    , lock_()
+    , file_(path, std::ios::out | std::ios::trunc)
+    , first_(true)
+    , threads_()
+    , marks_()
+    , tasks_()
+{
+    if (false == file_.good()) {
+        LogOutput(__FUNCTION__)(": Unable to open ")(path).Flush();
+
+        return;
+    }
+
+    file_ << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+}
+
+void Tracer::Begin(
+    const std::string& name,
+    const std::string& cookie,
+    const Clock::time_point time)
+{
+    Lock lock(lock_);
+    std::stringstream event{};
+    event << std::fixed << std::setprecision(3);
+    event << "{\"name\":\"" << name << "\",\"cat\":\"" TRACE_CATEGORY
+          << "\",\"ph\":\"b\",\"id\":\"" << escape(cookie)
+          << "\",\"ts\":" << timestamp(time) << ",\"pid\":" << pid_
+          << ",\"tid\":" << thread(lock) << ",\"args\":{\"cookie\":\""
+          << escape(cookie) << "\"}}";
+    write(lock, event.str());
+}
+
+void Tracer::End(
+    const std::string& name,
+    const std::string& cookie,
+    const Clock::time_point time)
+{
+    Lock lock(lock_);
+    std::stringstream event{};
+    event << std::fixed << std::setprecision(3);
+    event << "{\"name\":\"" << name << "\",\"cat\":\"" TRACE_CATEGORY
+          << "\",\"ph\":\"e\",\"id\":\"" << escape(cookie)
+          << "\",\"ts\":" << timestamp(time) << ",\"pid\":" << pid_
+          << ",\"tid\":" << thread(lock) << "}";
+    write(lock, event.str());
+}
+
+std::string Tracer::escape(const std::string& in)
+{
+    std::string output{};
+    output.reserve(in.size());
+
+    for (const auto c : in) {
+        if (('"' == c) || ('\\' == c)) {
+            output += '\\';
+            output += c;
+        } else if (0x20 > static_cast<unsigned char>(c)) {
+            char hex[8]{};
+            std::snprintf(hex, sizeof(hex), "\\u%04x", c);
+            output += hex;
+        } else {
+            output += c;
+        }
+    }
+
+    return output;
+}
+
+void Tracer::Mark()
+{
+    Lock lock(lock_);
+    marks_[std::this_thread::get_id()] = Clock::now();
+}
+
+void Tracer::Phase(const std::string& name, const std::string& cookie)
+{
+    const auto now = Clock::now();
+    Lock lock(lock_);
+    auto& mark = marks_[std::this_thread::get_id()];
+
+    if (Clock::time_point{} == mark) { mark = now; }
+
+    const auto begin = timestamp(mark);
+    std::stringstream event{};
+    event << std::fixed << std::setprecision(3);
+    event << "{\"name\":\"" << name << "\",\"cat\":\"" TRACE_CATEGORY
+          << "\",\"ph\":\"X\",\"ts\":" << begin
+          << ",\"dur\":" << (timestamp(now) - begin) << ",\"pid\":" << pid_
+          << ",\"tid\":" << thread(lock) << ",\"args\":{\"cookie\":\""
+          << escape(cookie) << "\"}}";
+    write(lock, event.str());
+    mark = now;
+}
+
+void Tracer::TaskComplete(const std::string& task)
+{
+    std::string cookie{};
+
+    {
+        Lock lock(lock_);
+        const auto it = tasks_.find(task);
+
+        if (tasks_.end() == it) { return; }
+
+        cookie = it->second;
+        tasks_.erase(it);
+    }
+
+    End("task " + escape(task), cookie);
+}
+
+void Tracer::TaskQueued(const std::string& cookie, const std::string& task)
+{
+    {
+        Lock lock(lock_);
+        tasks_[task] = cookie;
+    }
+
+    Begin("task " + escape(task), cookie);
+}
+
+int Tracer::thread(const Lock&)
+{
+    const auto id = std::this_thread::get_id();
+    const auto it = threads_.find(id);
+
+    if (threads_.end() != it) { return it->second; }
+
+    const auto output = static_cast<int>(threads_.size()) + 1;
+    threads_.emplace(id, output);
+
+    return output;
+}
+
+double Tracer::timestamp(const Clock::time_point time) const
+{
+    return std::chrono::duration<double, std::micro>(time - start_).count();
+}
+
+void Tracer::write(const Lock&, const std::string& event)
+{
+    if (false == file_.good()) { return; }
+
+    if (false == first_) { file_ << ",\n"; }
+
+    file_ << event;
+    first_ = false;
+}
+
+Tracer::~Tracer()
+{
+    if (file_.good()) { file_ << "\n]}\n"; }
+}
+}  // namespace opentxs::otctl
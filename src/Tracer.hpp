@@ -0,0 +1,71 @@
+// Copyright (c) 2019 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <opentxs/opentxs.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace opentxs::otctl
+{
+// Writes Chrome trace-event JSON, viewable in chrome://tracing or Perfetto
+//
+// Phases which run on one thread (parse, validate, serialize, decode, render)
+// become complete events measured from the calling thread's last mark. The
+// wait for a reply and the life of a queued task become async events keyed
+// by the command cookie, so a task nests under the command which queued it.
+class Tracer
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    void Begin(
+        const std::string& name,
+        const std::string& cookie,
+        const Clock::time_point time = Clock::now());
+    void End(
+        const std::string& name,
+        const std::string& cookie,
+        const Clock::time_point time = Clock::now());
+    void Mark();
+    // Emits a span from this thread's mark until now, then marks again
+    void Phase(const std::string& name, const std::string& cookie);
+    void TaskComplete(const std::string& task);
+    void TaskQueued(const std::string& cookie, const std::string& task);
+
+    Tracer(const std::string& path);
+
+    ~Tracer();
+
+private:
+    const Clock::time_point start_;
+    const int pid_;
+    std::mutex lock_;
+    std::ofstream file_;
+    bool first_;
+    std::map<std::thread::id, int> threads_;
+    std::map<std::thread::id, Clock::time_point> marks_;
+    std::map<std::string, std::string> tasks_;
+
+    static std::string escape(const std::string& in);
+
+    int thread(const Lock& lock);
+    double timestamp(const Clock::time_point time) const;
+    void write(const Lock& lock, const std::string& event);
+
+    Tracer() = delete;
+    Tracer(const Tracer&) = delete;
+    Tracer(Tracer&&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+    Tracer& operator=(Tracer&&) = delete;
+};
+}  // namespace opentxs::otctl
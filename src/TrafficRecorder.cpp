@@ -0,0 +1,182 @@
+// Copyright (c) 2019 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "TrafficRecorder.hpp"
+
+#include <opentxs/opentxs.hpp>
+
+#include "MappedFile.hpp"
+
+#include <chrono>
+#include <cstring>
+
+#define TRAFFIC_RECORDER_VERSION 1
+#define TRAFFIC_BUFFER_BYTES (256 * 1024)
+#define TRAFFIC_WRITE_INTERVAL_MILLISECONDS 100
+
+namespace
+{
+template <typename T>
+void append(std::string& out, const T value)
+{
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+T extract(const std::uint8_t* in)
+{
+    T output{};
+    std::memcpy(&output, in, sizeof(output));
+
+    return output;
+}
+}  // namespace
+
+namespace opentxs::otctl
+{
+const char TrafficRecorder::Magic[8] = {'O', 'T', 'C', 'T', 'L', 'R', 'E', 'C'};
+
+TrafficRecorder::TrafficRecorder(const std::string& path)
+    : good_(false)
+    , file_(path, std::ios::out | std::ios::binary | std::ios::trunc)
+    , lock_()
+    , signal_()
+    , buffer_()
+    , running_(true)
+    , writer_()
+{
+    if (false == file_.good()) {
+        LogOutput(__FUNCTION__)(": Unable to open ")(path).Flush();
+
+        return;
+    }
+
+    std::string header(Magic, sizeof(Magic));
+    append(header, std::uint32_t{TRAFFIC_RECORDER_VERSION});
+    file_.write(header.data(), header.size());
+    buffer_.reserve(TRAFFIC_BUFFER_BYTES);
+    good_ = true;
+    writer_ = std::thread(&TrafficRecorder::write, this);
+}
+
+bool TrafficRecorder::Read(const std::string& path, std::vector<Record>& out)
+{
+    const MappedFile file(path);
+
+    if ((false == file.good()) || (HeaderSize > file.size()) ||
+        (0 != std::memcmp(file.data(), Magic, sizeof(Magic)))) {
+        LogOutput(__FUNCTION__)(": ")(path)(" is not a traffic capture")
+            .Flush();
+
+        return false;
+    }
+
+    std::size_t position{HeaderSize};
+
+    while (position + RecordFixed <= file.size()) {
+        const auto* record = file.data() + position;
+        const auto size = std::size_t{sizeof(std::uint32_t)} +
+                          extract<std::uint32_t>(record);
+
+        if ((RecordFixed > size) || (size > file.size() - position)) {
+            break;
+        }
+
+        Record item{};
+        item.time_ = extract<std::uint64_t>(record + 4);
+        item.direction_ = static_cast<Direction>(record[12]);
+        item.instance_ = extract<std::int32_t>(record + 13);
+        item.data_.assign(
+            reinterpret_cast<const char*>(record) + RecordFixed,
+            size - RecordFixed);
+        out.emplace_back(std::move(item));
+        position += size;
+    }
+
+    if (position != file.size()) {
+        LogOutput(__FUNCTION__)(": Ignoring ")(file.size() - position)(
+            " truncated bytes at the end of ")(path)
+            .Flush();
+    }
+
+    return true;
+}
+
+void TrafficRecorder::Write(
+    const Direction direction,
+    const void* data,
+    const std::size_t size,
+    const std::int32_t instance)
+{
+    if (false == good_) { return; }
+
+    const auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         std::chrono::system_clock::now().time_since_epoch())
+                         .count();
+    bool full{false};
+
+    {
+        Lock lock(lock_);
+        append(
+            buffer_,
+            static_cast<std::uint32_t>(RecordFixed - sizeof(std::uint32_t) +
+                                       size));
+        append(buffer_, static_cast<std::uint64_t>(now));
+        append(buffer_, static_cast<std::uint8_t>(direction));
+        append(buffer_, instance);
+        buffer_.append(static_cast<const char*>(data), size);
+        full = (TRAFFIC_BUFFER_BYTES <= buffer_.size());
+    }
+
+    if (full) { signal_.notify_one(); }
+}
+
+void TrafficRecorder::write()
+{
+    const std::chrono::milliseconds interval{
+        TRAFFIC_WRITE_INTERVAL_MILLISECONDS};
+    std::string pending{};
+    pending.reserve(TRAFFIC_BUFFER_BYTES);
+
+    while (true) {
+        const auto running = running_.load();
+
+        {
+            Lock lock(lock_);
+
+            if (running) {
+                signal_.wait_for(lock, interval, [&] {
+                    return (TRAFFIC_BUFFER_BYTES <= buffer_.size()) ||
+                           (false == running_.load());
+                });
+            }
+
+            pending.swap(buffer_);
+        }
+
+        if (false == pending.empty()) {
+            file_.write(pending.data(), pending.size());
+            pending.clear();
+        }
+
+        if (false == running) { break; }
+    }
+}
+
+TrafficRecorder::~TrafficRecorder()
+{
+    if (writer_.joinable()) {
+        {
+            Lock lock(lock_);
+            running_.store(false);
+        }
+
+        signal_.notify_one();
+        writer_.join();
+    }
+
+    file_.flush();
+}
+}  // namespace opentxs::otctl
@@ -0,0 +1,81 @@
+// Copyright (c) 2019 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace opentxs::otctl
+{
+// Capture of every frame exchanged with otagent
+//
+// The file is a short header followed by length-prefixed records, each holding
+// the wall clock time, the direction, the push instance and the serialized
+// proto exactly as it crossed the socket. Callers only append to an in-memory
+// buffer; a writer thread moves full buffers to disk without flushing.
+class TrafficRecorder
+{
+public:
+    enum class Direction : std::uint8_t {
+        Command = 1,
+        Reply = 2,
+        Push = 3,
+    };
+
+    struct Record {
+        std::uint64_t time_{0};
+        Direction direction_{};
+        std::int32_t instance_{-1};
+        std::string data_{};
+    };
+
+    static const char Magic[8];
+    // magic, version
+    static constexpr std::size_t HeaderSize{12};
+    // size, time, direction, instance
+    static constexpr std::size_t RecordFixed{
+        sizeof(std::uint32_t) + sizeof(std::uint64_t) + sizeof(std::uint8_t) +
+        sizeof(std::int32_t)};
+
+    // Loads every intact record of a capture, in recorded order
+    static bool Read(const std::string& path, std::vector<Record>& out);
+
+    bool good() const { return good_; }
+
+    void Write(
+        const Direction direction,
+        const void* data,
+        const std::size_t size,
+        const std::int32_t instance = -1);
+
+    TrafficRecorder(const std::string& path);
+
+    ~TrafficRecorder();
+
+private:
+    bool good_;
+    std::ofstream file_;
+    std::mutex lock_;
+    std::condition_variable signal_;
+    std::string buffer_;
+    std::atomic<bool> running_;
+    std::thread writer_;
+
+    void write();
+
+    TrafficRecorder() = delete;
+    TrafficRecorder(const TrafficRecorder&) = delete;
+    TrafficRecorder(TrafficRecorder&&) = delete;
+    TrafficRecorder& operator=(const TrafficRecorder&) = delete;
+    TrafficRecorder& operator=(TrafficRecorder&&) = delete;
+};
+}  // namespace opentxs::otctl
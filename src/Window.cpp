@@ -0,0 +1,119 @@
+// Copyright (c) 2019 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "Window.hpp"
+
+#include <algorithm>
+
+// Latency this many times the baseline counts as congestion
+#define WINDOW_CONGESTION_FACTOR 4
+// Weight of each new sample in the baseline is 1 / WINDOW_BASELINE_WEIGHT
+#define WINDOW_BASELINE_WEIGHT 8
+// Shorter replies are counted as this long, so a few unusually fast replies
+// can not make every normal one look congested
+#define WINDOW_LATENCY_FLOOR_US 1000
+
+namespace opentxs::otctl
+{
+Window::Window(const std::size_t limit, const bool adaptive)
+    : lock_()
+    , cv_()
+    , ceiling_(std::max(limit, std::size_t{1}))
+    , adaptive_(adaptive)
+    , limit_(ceiling_)
+    , in_flight_(0)
+    , replies_(0)
+    , since_decrease_(ceiling_)
+    , baseline_(0)
+{
+}
+
+bool Window::Acquire(const std::chrono::milliseconds timeout)
+{
+    std::unique_lock<std::mutex> lock(lock_);
+    const auto ready =
+        cv_.wait_for(lock, timeout, [this] { return in_flight_ < limit_; });
+
+    if (ready) { ++in_flight_; }
+
+    return ready;
+}
+
+void Window::Feedback(
+    const std::chrono::nanoseconds latency,
+    const bool retry)
+{
+    if (false == adaptive_) { return; }
+
+    bool grew{false};
+
+    {
+        std::unique_lock<std::mutex> lock(lock_);
+        const auto congested =
+            retry || ((0 < baseline_.count()) &&
+                      (latency > WINDOW_CONGESTION_FACTOR * baseline_));
+
+        // Refused commands say nothing about how long otagent takes
+        if (false == retry) {
+            const auto sample = std::max<std::chrono::nanoseconds>(
+                latency, std::chrono::microseconds(WINDOW_LATENCY_FLOOR_US));
+            baseline_ = (0 == baseline_.count())
+                            ? sample
+                            : baseline_ + (sample - baseline_) /
+                                              WINDOW_BASELINE_WEIGHT;
+        }
+
+        ++replies_;
+        ++since_decrease_;
+
+        if (congested) {
+            // Part of the burst which caused the last decrease
+            if (since_decrease_ < limit_) { return; }
+
+            limit_ = std::max(limit_ / 2, std::size_t{1});
+            replies_ = 0;
+            since_decrease_ = 0;
+        } else if ((replies_ >= limit_) && (limit_ < ceiling_)) {
+            ++limit_;
+            replies_ = 0;
+            grew = true;
+        }
+    }
+
+    if (grew) { cv_.notify_all(); }
+}
+
+std::size_t Window::InFlight() const
+{
+    std::unique_lock<std::mutex> lock(lock_);
+
+    return in_flight_;
+}
+
+void Window::Release()
+{
+    {
+        std::unique_lock<std::mutex> lock(lock_);
+
+        if (0 < in_flight_) { --in_flight_; }
+    }
+
+    cv_.notify_all();
+}
+
+std::size_t Window::Limit() const
+{
+    std::unique_lock<std::mutex> lock(lock_);
+
+    return limit_;
+}
+
+bool Window::Wait(const std::chrono::milliseconds timeout)
+{
+    std::unique_lock<std::mutex> lock(lock_);
+
+    return cv_.wait_for(lock, timeout, [this] { return 0 == in_flight_; });
+}
+}  // namespace opentxs::otctl
@@ -0,0 +1,59 @@
+// Copyright (c) 2019 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+
+namespace opentxs::otctl
+{
+// Bounds the number of requests in flight during pipelined operations
+//
+// An adaptive window treats its limit as a ceiling and adjusts the number of
+// usable slots AIMD style from reply feedback: one more slot after a full
+// window of healthy replies, half as many when otagent asks for a retry or
+// replies take several times longer than a moving average of recent replies.
+// After a decrease, further congestion signals are ignored for one window so
+// that a single burst only counts once.
+class Window
+{
+public:
+    // Blocks until a slot is free. Returns false on timeout.
+    bool Acquire(const std::chrono::milliseconds timeout);
+    // Adjusts an adaptive window. Ignored by fixed windows.
+    void Feedback(const std::chrono::nanoseconds latency, const bool retry);
+    std::size_t InFlight() const;
+    std::size_t Limit() const;
+    void Release();
+    // Blocks until every slot is released. Returns false on timeout.
+    bool Wait(const std::chrono::milliseconds timeout);
+
+    explicit Window(const std::size_t limit, const bool adaptive = false);
+
+    ~Window() = default;
+
+private:
+    mutable std::mutex lock_;
+    std::condition_variable cv_;
+    const std::size_t ceiling_;
+    const bool adaptive_;
+    std::size_t limit_;
+    std::size_t in_flight_;
+    // Replies since the limit last changed
+    std::size_t replies_;
+    std::size_t since_decrease_;
+    // Moving average of reply latency, zero until the first reply
+    std::chrono::nanoseconds baseline_;
+
+    Window() = delete;
+    Window(const Window&) = delete;
+    Window(Window&&) = delete;
+    Window& operator=(const Window&) = delete;
+    Window& operator=(Window&&) = delete;
+};
+}  // namespace opentxs::otctl
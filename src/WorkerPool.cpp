@@ -0,0 +1,79 @@
+// Copyright (c) 2019 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "WorkerPool.hpp"
+
+#include <algorithm>
+
+namespace opentxs::otctl
+{
+WorkerPool::WorkerPool(const std::size_t threads)
+    : lock_()
+    , work_()
+    , idle_()
+    , jobs_()
+    , running_(0)
+    , shutdown_(false)
+    , threads_()
+{
+    const auto count = (0 == threads)
+                           ? std::max(std::thread::hardware_concurrency(), 1u)
+                           : threads;
+
+    for (std::size_t i{0}; i < count; ++i) {
+        threads_.emplace_back(&WorkerPool::worker, this);
+    }
+}
+
+void WorkerPool::Post(Job job)
+{
+    {
+        std::unique_lock<std::mutex> lock(lock_);
+        jobs_.emplace_back(std::move(job));
+    }
+
+    work_.notify_one();
+}
+
+void WorkerPool::Wait()
+{
+    std::unique_lock<std::mutex> lock(lock_);
+    idle_.wait(lock, [this] { return jobs_.empty() && (0 == running_); });
+}
+
+void WorkerPool::worker()
+{
+    std::unique_lock<std::mutex> lock(lock_);
+
+    while (true) {
+        work_.wait(
+            lock, [this] { return shutdown_ || (false == jobs_.empty()); });
+
+        if (jobs_.empty()) { return; }
+
+        auto job = std::move(jobs_.front());
+        jobs_.pop_front();
+        ++running_;
+        lock.unlock();
+        job();
+        lock.lock();
+        --running_;
+
+        if (jobs_.empty() && (0 == running_)) { idle_.notify_all(); }
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::unique_lock<std::mutex> lock(lock_);
+        shutdown_ = true;
+    }
+
+    work_.notify_all();
+
+    for (auto& thread : threads_) { thread.join(); }
+}
+}  // namespace opentxs::otctl
@@ -0,0 +1,49 @@
+// Copyright (c) 2019 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace opentxs::otctl
+{
+// Runs work off the socket thread so that reply callbacks return immediately
+class WorkerPool
+{
+public:
+    using Job = std::function<void()>;
+
+    void Post(Job job);
+    // Blocks until every posted job has finished
+    void Wait();
+
+    // Zero threads means one per hardware thread
+    explicit WorkerPool(const std::size_t threads = 0);
+
+    ~WorkerPool();
+
+private:
+    std::mutex lock_;
+    std::condition_variable work_;
+    std::condition_variable idle_;
+    std::deque<Job> jobs_;
+    std::size_t running_;
+    bool shutdown_;
+    std::vector<std::thread> threads_;
+
+    void worker();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool(WorkerPool&&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+    WorkerPool& operator=(WorkerPool&&) = delete;
+};
+}  // namespace opentxs::otctl
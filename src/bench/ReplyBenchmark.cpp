@@ -0,0 +1,361 @@
+// Copyright (c) 2019 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "ReplyBenchmark.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+
+#define BENCH_RPC_VERSION 1
+#define BENCH_ACCOUNT_EVENT_VERSION 2
+#define BENCH_AMOUNT 100
+
+namespace zmq = opentxs::network::zeromq;
+
+namespace opentxs::otctl
+{
+ReplyBenchmark::ReplyBenchmark(
+    CLI& cli,
+    const Settings& settings,
+    AllocationCounter allocations)
+    : cli_(cli)
+    , settings_(settings)
+    , allocations_(allocations)
+    , cases_()
+{
+    auto accounts = response(proto::RPCCOMMAND_LISTACCOUNTS, 1);
+
+    for (std::size_t i{0}; i < settings_.identifiers_; ++i) {
+        accounts.add_identifier(Identifier::Random()->str());
+    }
+
+    add_reply("listaccounts", accounts);
+
+    auto balance =
+        response(proto::RPCCOMMAND_GETACCOUNTBALANCE, settings_.balances_);
+
+    for (std::size_t i{0}; i < settings_.balances_; ++i) {
+        auto& item = *balance.add_balance();
+        item.set_version(BENCH_RPC_VERSION);
+        item.set_id(Identifier::Random()->str());
+        item.set_label("Benchmark account");
+        item.set_unit(Identifier::Random()->str());
+        item.set_owner(Identifier::Random()->str());
+        item.set_issuer(Identifier::Random()->str());
+        item.set_balance(BENCH_AMOUNT);
+        item.set_pendingbalance(BENCH_AMOUNT);
+        item.set_type(proto::ACCOUNTTYPE_NORMAL);
+    }
+
+    add_reply("getaccountbalance", balance);
+
+    auto activity = response(proto::RPCCOMMAND_GETACCOUNTACTIVITY, 1);
+    const auto account = Identifier::Random()->str();
+    proto::AccountEvent event{};
+    event.set_version(BENCH_ACCOUNT_EVENT_VERSION);
+    event.set_id(account);
+    event.set_type(proto::ACCOUNTEVENT_INCOMINGTRANSFER);
+    event.set_amount(BENCH_AMOUNT);
+    event.set_pendingamount(BENCH_AMOUNT);
+    event.set_timestamp(std::time(nullptr));
+    event.set_memo("Benchmark transfer");
+
+    for (std::size_t i{0}; i < settings_.events_; ++i) {
+        auto& item = *activity.add_accountevent();
+        item = event;
+        item.set_contact(Identifier::Random()->str());
+        item.set_workflow(Identifier::Random()->str());
+        item.set_uuid(Identifier::Random()->str());
+    }
+
+    add_reply("getaccountactivity", activity);
+
+    // Synthetic workflows carry no real instruments and therefore fail
+    // validation, so only the handler itself is measured
+    auto workflows = response(proto::RPCCOMMAND_GETWORKFLOW, 1);
+    auto& workflow = *workflows.add_workflow();
+    workflow.set_version(BENCH_RPC_VERSION);
+    workflow.set_id(Identifier::Random()->str());
+    workflow.set_type(proto::PAYMENTWORKFLOWTYPE_OUTGOINGCHEQUE);
+    workflow.set_state(proto::PAYMENTWORKFLOWSTATE_CONVEYED);
+    workflow.set_notary(Identifier::Random()->str());
+    workflow.add_party(Identifier::Random()->str());
+    workflow.add_unit(Identifier::Random()->str());
+    workflow.add_account(account);
+
+    for (std::size_t i{0}; i < settings_.events_; ++i) {
+        auto& item = *workflow.add_event();
+        item.set_version(BENCH_RPC_VERSION);
+        item.set_type(proto::PAYMENTEVENTTYPE_CONVEY);
+        item.add_item(std::string(256, 'x'));
+        item.set_time(std::time(nullptr));
+        item.set_nym(Identifier::Random()->str());
+        item.set_success(true);
+    }
+
+    add_reply("getworkflow", workflows, false);
+
+    // Every other handler gets a reply sized by the same settings, so a new
+    // entry in CLI::response_handlers_ is benchmarked without further work
+    for (const auto& it : CLI::response_handlers_) {
+        const auto type = it.first;
+
+        if (0 < replies_.count(type)) { continue; }
+
+        // Fabricated contracts carry no signatures and fail validation
+        const auto validates = (proto::RPCCOMMAND_GETNYM != type) &&
+                               (proto::RPCCOMMAND_GETUNITDEFINITION != type) &&
+                               (proto::RPCCOMMAND_GETSERVERCONTRACT != type);
+        add_reply(CLI::get_command_name(type), fabricate(type), validates);
+    }
+
+    proto::RPCPush push{};
+    push.set_version(BENCH_RPC_VERSION);
+    push.set_type(proto::RPCPUSH_ACCOUNT);
+    push.set_id(Identifier::Random()->str());
+    *push.mutable_accountevent() = event;
+    add_push("accountpush", push);
+
+    push.clear_accountevent();
+    push.set_type(proto::RPCPUSH_TASK);
+    auto& task = *push.mutable_taskcomplete();
+    task.set_version(BENCH_RPC_VERSION);
+    task.set_id(Identifier::Random()->str());
+    task.set_result(true);
+    add_push("taskpush", push);
+}
+
+void ReplyBenchmark::add_push(
+    const std::string& name,
+    const proto::RPCPush& push)
+{
+    const auto handler = CLI::push_handlers_.at(push.type());
+    auto message = std::make_shared<OTZMQMessage>(zmq::Message::Factory());
+    const std::int32_t instance{0};
+    (*message)->AddFrame();
+    (*message)->AddFrame(std::string("PUSH"));
+    (*message)->AddFrame(push);
+    (*message)->AddFrame(&instance, sizeof(instance));
+    const auto bytes = push.SerializeAsString().size();
+    cases_.push_back({name + " (decode)", bytes, [this, message]() {
+                          cli_.callback(*message);
+                      }});
+    cases_.push_back({name + " (render)",
+                      bytes,
+                      [this, handler, push]() { (cli_.*handler)(push, 0); },
+                      true});
+}
+
+void ReplyBenchmark::add_reply(
+    const std::string& name,
+    const proto::RPCResponse& response,
+    const bool validates)
+{
+    const auto handler = CLI::response_handlers_.at(response.type());
+    const auto bytes = response.SerializeAsString().size();
+    replies_.emplace(response.type());
+
+    if (validates) {
+        auto message =
+            std::make_shared<OTZMQMessage>(zmq::Message::Factory());
+        (*message)->AddFrame();
+        (*message)->AddFrame(response);
+        cases_.push_back({name + " (decode)", bytes, [this, message]() {
+                              cli_.callback(*message);
+                          }});
+    }
+
+    cases_.push_back({name + " (render)",
+                      bytes,
+                      [this, handler, response]() {
+                          (cli_.*handler)(response);
+                      },
+                      true});
+}
+
+proto::RPCResponse ReplyBenchmark::fabricate(
+    const proto::RPCCommandType type) const
+{
+    auto output = response(type, 1);
+
+    switch (type) {
+        case proto::RPCCOMMAND_LISTCONTACTS:
+        case proto::RPCCOMMAND_LISTNYMS:
+        case proto::RPCCOMMAND_LISTHDSEEDS:
+        case proto::RPCCOMMAND_LISTSERVERCONTRACTS:
+        case proto::RPCCOMMAND_LISTUNITDEFINITIONS:
+        case proto::RPCCOMMAND_GETCOMPATIBLEACCOUNTS: {
+            for (std::size_t i{0}; i < settings_.identifiers_; ++i) {
+                output.add_identifier(Identifier::Random()->str());
+            }
+        } break;
+        case proto::RPCCOMMAND_LISTCLIENTSESSIONS:
+        case proto::RPCCOMMAND_LISTSERVERSESSIONS: {
+            for (std::size_t i{0}; i < settings_.balances_; ++i) {
+                auto& session = *output.add_sessions();
+                session.set_version(BENCH_RPC_VERSION);
+                session.set_instance(static_cast<std::uint32_t>(i));
+            }
+        } break;
+        case proto::RPCCOMMAND_GETNYM: {
+            output = response(type, settings_.balances_);
+
+            for (std::size_t i{0}; i < settings_.balances_; ++i) {
+                auto& nym = *output.add_nym();
+                nym.set_version(BENCH_RPC_VERSION);
+                nym.set_nymid(Identifier::Random()->str());
+                nym.set_revision(1);
+            }
+        } break;
+        case proto::RPCCOMMAND_GETHDSEED: {
+            output = response(type, settings_.balances_);
+
+            for (std::size_t i{0}; i < settings_.balances_; ++i) {
+                auto& seed = *output.add_seed();
+                seed.set_version(BENCH_RPC_VERSION);
+                seed.set_id(Identifier::Random()->str());
+                seed.set_words("benchmark words");
+            }
+        } break;
+        case proto::RPCCOMMAND_GETSERVERCONTRACT: {
+            output = response(type, settings_.balances_);
+
+            for (std::size_t i{0}; i < settings_.balances_; ++i) {
+                auto& notary = *output.add_notary();
+                notary.set_version(BENCH_RPC_VERSION);
+                notary.set_id(Identifier::Random()->str());
+            }
+        } break;
+        case proto::RPCCOMMAND_GETUNITDEFINITION: {
+            output = response(type, settings_.balances_);
+
+            for (std::size_t i{0}; i < settings_.balances_; ++i) {
+                auto& unit = *output.add_unit();
+                unit.set_version(BENCH_RPC_VERSION);
+                unit.set_id(Identifier::Random()->str());
+                unit.set_nymid(Identifier::Random()->str());
+                unit.set_name("Benchmark units");
+                unit.set_shortname("BNC");
+                unit.set_terms(std::string(256, 'x'));
+            }
+        } break;
+        case proto::RPCCOMMAND_GETPENDINGPAYMENTS: {
+            for (std::size_t i{0}; i < settings_.events_; ++i) {
+                auto& event = *output.add_accountevent();
+                event.set_version(BENCH_ACCOUNT_EVENT_VERSION);
+                event.set_id(Identifier::Random()->str());
+                event.set_type(proto::ACCOUNTEVENT_INCOMINGCHEQUE);
+                event.set_contact(Identifier::Random()->str());
+                event.set_workflow(Identifier::Random()->str());
+                event.set_pendingamount(BENCH_AMOUNT);
+                event.set_timestamp(std::time(nullptr));
+                event.set_memo("Benchmark cheque");
+            }
+        } break;
+        case proto::RPCCOMMAND_GETTRANSACTIONDATA: {
+            output = response(type, settings_.balances_);
+
+            for (std::size_t i{0}; i < settings_.balances_; ++i) {
+                auto& data = *output.add_transactiondata();
+                data.set_version(BENCH_RPC_VERSION);
+                data.set_uuid(Identifier::Random()->str());
+                data.set_type(proto::ACCOUNTEVENT_OUTGOINGTRANSFER);
+                data.add_sourceaccounts(Identifier::Random()->str());
+                data.add_destinationaccounts(Identifier::Random()->str());
+                data.set_amount(BENCH_AMOUNT);
+                data.set_state(proto::PAYMENTWORKFLOWSTATE_COMPLETED);
+            }
+        } break;
+        case proto::RPCCOMMAND_ACCEPTPENDINGPAYMENTS: {
+            output = response(type, settings_.balances_);
+
+            for (std::size_t i{0}; i < settings_.balances_; ++i) {
+                auto& task = *output.add_task();
+                task.set_version(BENCH_RPC_VERSION);
+                task.set_index(static_cast<std::uint32_t>(i));
+                task.set_id(Identifier::Random()->str());
+            }
+        } break;
+        case proto::RPCCOMMAND_ADDCLIENTSESSION:
+        case proto::RPCCOMMAND_ADDSERVERSESSION: {
+            output.set_session(0);
+        } break;
+        case proto::RPCCOMMAND_REGISTERNYM:
+        case proto::RPCCOMMAND_ISSUEUNITDEFINITION:
+        case proto::RPCCOMMAND_CREATEACCOUNT:
+        case proto::RPCCOMMAND_CREATECOMPATIBLEACCOUNT:
+        case proto::RPCCOMMAND_SENDPAYMENT:
+        case proto::RPCCOMMAND_MOVEFUNDS: {
+            auto& task = *output.add_task();
+            task.set_version(BENCH_RPC_VERSION);
+            task.set_index(0);
+            task.set_id(Identifier::Random()->str());
+        } break;
+        default: {
+            // Commands which create or import one object reply with its ID
+            output.add_identifier(Identifier::Random()->str());
+        }
+    }
+
+    return output;
+}
+
+ReplyBenchmark::Result ReplyBenchmark::measure(const Case& item) const
+{
+    using Clock = std::chrono::steady_clock;
+
+    Result output{};
+    output.name_ = item.name_;
+    output.bytes_ = item.bytes_;
+    output.iterations_ = std::max<std::uint64_t>(settings_.iterations_, 1);
+    output.render_ = item.render_;
+    item.run_();
+    const auto allocations = allocations_();
+    const auto start = Clock::now();
+
+    for (std::uint64_t i{0}; i < output.iterations_; ++i) { item.run_(); }
+
+    const auto elapsed = Clock::now() - start;
+    const auto count = static_cast<double>(output.iterations_);
+    output.nanoseconds_ =
+        static_cast<double>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+                .count()) /
+        count;
+    output.allocations_ =
+        static_cast<double>(allocations_() - allocations) / count;
+
+    return output;
+}
+
+proto::RPCResponse ReplyBenchmark::response(
+    const proto::RPCCommandType type,
+    const std::size_t statuses)
+{
+    proto::RPCResponse output{};
+    output.set_version(BENCH_RPC_VERSION);
+    output.set_cookie(Identifier::Random()->str());
+    output.set_type(type);
+
+    for (std::size_t i{0}; i < statuses; ++i) {
+        auto& status = *output.add_status();
+        status.set_version(BENCH_RPC_VERSION);
+        status.set_index(static_cast<std::uint32_t>(i));
+        status.set_code(proto::RPCRESPONSE_SUCCESS);
+    }
+
+    return output;
+}
+
+std::vector<ReplyBenchmark::Result> ReplyBenchmark::Run()
+{
+    std::vector<Result> output{};
+
+    for (const auto& item : cases_) { output.emplace_back(measure(item)); }
+
+    return output;
+}
+}  // namespace opentxs::otctl
@@ -0,0 +1,94 @@
+// Copyright (c) 2019 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <opentxs/opentxs.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "CLI.hpp"
+
+namespace opentxs::otctl
+{
+// Drives synthetic replies and pushes through the CLI's receive path
+//
+// Every case is measured twice: once through callback(), which includes
+// decoding, validation, tracking and dispatch, and once by calling the
+// response or push handler directly on an already decoded message. The
+// handlers write through LogOutput, which only enqueues each line for the
+// opentxs logging thread, so render results exclude the terminal write.
+//
+// Replies of the commonly bulk commands are built explicitly. Every other
+// entry of CLI::response_handlers_ gets a generated reply sized by the same
+// settings.
+class ReplyBenchmark
+{
+public:
+    struct Settings {
+        std::size_t iterations_{100};
+        std::size_t identifiers_{100000};
+        std::size_t events_{1000};
+        std::size_t balances_{100};
+    };
+
+    struct Result {
+        std::string name_{};
+        std::size_t bytes_{0};
+        std::uint64_t iterations_{0};
+        double nanoseconds_{0};
+        double allocations_{0};
+        // Handler only, output enqueued but not written
+        bool render_{false};
+    };
+
+    using AllocationCounter = std::function<std::uint64_t()>;
+
+    std::vector<Result> Run();
+
+    ReplyBenchmark(
+        CLI& cli,
+        const Settings& settings,
+        AllocationCounter allocations);
+
+    ~ReplyBenchmark() = default;
+
+private:
+    struct Case {
+        std::string name_{};
+        std::size_t bytes_{0};
+        std::function<void()> run_{};
+        bool render_{false};
+    };
+
+    CLI& cli_;
+    const Settings settings_;
+    AllocationCounter allocations_;
+    std::vector<Case> cases_;
+    std::set<proto::RPCCommandType> replies_;
+
+    static proto::RPCResponse response(
+        const proto::RPCCommandType type,
+        const std::size_t statuses);
+
+    void add_push(const std::string& name, const proto::RPCPush& push);
+    void add_reply(
+        const std::string& name,
+        const proto::RPCResponse& response,
+        const bool validates = true);
+    proto::RPCResponse fabricate(const proto::RPCCommandType type) const;
+    Result measure(const Case& item) const;
+
+    ReplyBenchmark() = delete;
+    ReplyBenchmark(const ReplyBenchmark&) = delete;
+    ReplyBenchmark(ReplyBenchmark&&) = delete;
+    ReplyBenchmark& operator=(const ReplyBenchmark&) = delete;
+    ReplyBenchmark& operator=(ReplyBenchmark&&) = delete;
+};
+}  // namespace opentxs::otctl
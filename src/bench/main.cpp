@@ -0,0 +1,142 @@
+// Copyright (c) 2019 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <opentxs/opentxs.hpp>
+
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+
+#include "ReplyBenchmark.hpp"
+
+namespace fs = boost::filesystem;
+namespace po = boost::program_options;
+
+namespace
+{
+std::atomic<std::uint64_t> allocations_{0};
+}  // namespace
+
+void* operator new(std::size_t size)
+{
+    ++allocations_;
+
+    if (auto* output = std::malloc((0 == size) ? 1 : size)) { return output; }
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) { return operator new(size); }
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+int main(int argc, char** argv)
+{
+    opentxs::otctl::ReplyBenchmark::Settings settings{};
+    bool json{false};
+
+    auto options = po::options_description{"otctl_bench"};
+    options.add_options()(
+        "iterations",
+        po::value<std::size_t>(&settings.iterations_)->default_value(100),
+        "Messages per case")(
+        "identifiers",
+        po::value<std::size_t>(&settings.identifiers_)->default_value(100000),
+        "Identifiers in the listaccounts reply")(
+        "events",
+        po::value<std::size_t>(&settings.events_)->default_value(1000),
+        "Events in the activity and workflow replies")(
+        "balances",
+        po::value<std::size_t>(&settings.balances_)->default_value(100),
+        "Accounts in the getaccountbalance reply")(
+        "json", po::bool_switch(&json), "Print results as JSON");
+    auto variables = po::variables_map{};
+
+    try {
+        po::store(po::parse_command_line(argc, argv, options), variables);
+        po::notify(variables);
+    } catch (const po::error& e) {
+        std::cerr << "ERROR: " << e.what() << "\n\n" << options << std::endl;
+
+        return 1;
+    }
+
+    // The CLI needs an endpoint and a key file but never sends anything
+    const auto keyfile =
+        (fs::temp_directory_path() / fs::unique_path("otctl-bench-%%%%%%.key"))
+            .string();
+    std::ofstream(keyfile) << "{\"otagent\":{}}";
+    po::variables_map cli{};
+    cli.emplace("keyfile", po::variable_value(keyfile, false));
+    cli.emplace(
+        "endpoint",
+        po::variable_value(std::string("ipc:///tmp/otctl-bench.sock"), false));
+    const auto& ot = opentxs::InitContext();
+    auto otctl = std::make_unique<opentxs::otctl::CLI>(ot, cli);
+    std::vector<opentxs::otctl::ReplyBenchmark::Result> results{};
+
+    {
+        opentxs::otctl::ReplyBenchmark bench(
+            *otctl, settings, [] { return allocations_.load(); });
+        results = bench.Run();
+    }
+
+    otctl.reset();
+    fs::remove(keyfile);
+    opentxs::Cleanup();
+    opentxs::Join();
+
+    if (json) {
+        std::cout << "[\n";
+
+        for (std::size_t i{0}; i < results.size(); ++i) {
+            const auto& result = results.at(i);
+            std::cout << "  {\"name\": " << std::quoted(result.name_)
+                      << ", \"bytes\": " << result.bytes_
+                      << ", \"iterations\": " << result.iterations_
+                      << ", \"ns_per_message\": " << result.nanoseconds_
+                      << ", \"allocations_per_message\": "
+                      << result.allocations_ << ", \"log_enqueued_only\": "
+                      << (result.render_ ? "true" : "false") << "}"
+                      << ((i + 1 < results.size()) ? ",\n" : "\n");
+        }
+
+        std::cout << "]" << std::endl;
+    } else {
+        std::cout << std::left << std::setw(32) << "case" << std::right
+                  << std::setw(12) << "bytes" << std::setw(16) << "ns/msg"
+                  << std::setw(16) << "allocs/msg" << "\n";
+
+        for (const auto& result : results) {
+            std::cout << std::left << std::setw(32) << result.name_
+                      << std::right << std::setw(12) << result.bytes_
+                      << std::setw(16) << std::fixed << std::setprecision(0)
+                      << result.nanoseconds_ << std::setw(16)
+                      << std::setprecision(1) << result.allocations_ << "\n";
+        }
+
+        std::cout << "\nrender cases time the handler up to enqueueing its "
+                     "LogOutput lines;\nwriting them to the terminal happens "
+                     "on the opentxs logging thread\nand is not included."
+                  << std::endl;
+    }
+
+    return 0;
+}
@@ -7,23 +7,85 @@
 
 #include <boost/program_options.hpp>
 
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "ActivityIndex.hpp"
 #include "CLI.hpp"
+#include "LogArchive.hpp"
+#include "Snapshot.hpp"
 
 namespace po = boost::program_options;
 
 int main(int argc, char** argv)
 {
+    // Global options precede an optional subcommand, which receives every
+    // remaining argument
+    int first{1};
+
+    while ((first < argc) && (0 == std::string(argv[first]).find("--"))) {
+        const auto hasValue =
+            std::string::npos != std::string(argv[first]).find('=');
+        first += hasValue ? 1 : 2;
+    }
+
+    first = std::min(first, argc);
+    const auto subcommand =
+        std::vector<std::string>(argv + first, argv + argc);
+
+    if ((false == subcommand.empty()) && ("logq" == subcommand.front())) {
+        return opentxs::otctl::LogArchive::Query(
+            {subcommand.begin() + 1, subcommand.end()});
+    }
+
+    if ((false == subcommand.empty()) && ("query" == subcommand.front())) {
+        return opentxs::otctl::ActivityIndex::Query(
+            {subcommand.begin() + 1, subcommand.end()});
+    }
+
+    if ((false == subcommand.empty()) && ("diff" == subcommand.front())) {
+        return opentxs::otctl::Snapshot::Diff(
+            {subcommand.begin() + 1, subcommand.end()});
+    }
+
     auto options = po::options_description{"otctl"};
     options.add_options()(
         "keyfile",
         po::value<std::string>(),
         "Path to file containing endpoint keys.")(
         "endpoint", po::value<std::string>(), "Remote zmq endpoint")(
-        "logendpoint", po::value<std::string>(), "Source of otagent logs");
+        "fleet",
+        po::value<std::string>(),
+        "File listing the otagent endpoints addressed by fleet, one per "
+        "line, each optionally followed by a keyfile. --endpoint is not "
+        "included unless listed.")(
+        "logendpoint", po::value<std::string>(), "Source of otagent logs")(
+        "logfile",
+        po::value<std::string>(),
+        "Append received otagent logs to a binary archive (see logq).")(
+        "cache",
+        po::value<std::string>(),
+        "Path to a local cache of nyms, server contracts and unit "
+        "definitions.")(
+        "record",
+        po::value<std::string>(),
+        "Capture every command, reply and push to a file.")(
+        "trace",
+        po::value<std::string>(),
+        "Write a Chrome trace-event timeline of every command.")(
+        "activity",
+        po::value<std::string>(),
+        "Keep account events in a local store and only print new or changed "
+        "activity (see query).")(
+        "retries",
+        po::value<std::size_t>(),
+        "Resend commands answered with RETRY up to this many times, with "
+        "exponential backoff. Default 5, 0 disables.");
     auto variables = po::variables_map{};
 
     try {
-        po::store(po::parse_command_line(argc, argv, options), variables);
+        po::store(po::parse_command_line(first, argv, options), variables);
         po::notify(variables);
     } catch (const po::error& e) {
         std::cerr << "ERROR: " << e.what() << "\n\n" << options << std::endl;
@@ -34,11 +96,14 @@ int main(int argc, char** argv)
     const auto& ot = opentxs::InitContext();
     std::unique_ptr<opentxs::otctl::CLI> otctl;
     otctl.reset(new opentxs::otctl::CLI(ot, variables));
-    otctl->Run();
+
+    const auto status =
+        subcommand.empty() ? otctl->Run() : otctl->Run(subcommand);
+
     opentxs::LogNormal("Shutting down...").Flush();
     otctl.reset();
     opentxs::Cleanup();
     opentxs::Join();
 
-    return 0;
+    return status;
 }
@@ -0,0 +1,458 @@
+// Copyright (c) 2019 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "MockServer.hpp"
+
+#include <algorithm>
+#include <ctime>
+
+#define MOCK_VERSION 1
+#define MOCK_ACCOUNT_EVENT_VERSION 2
+#define MOCK_BALANCE 100000
+#define MOCK_AMOUNT 100
+// Seconds between consecutive events of a fabricated workflow
+#define MOCK_EVENT_INTERVAL 60
+
+namespace zmq = opentxs::network::zeromq;
+
+namespace opentxs::otctl
+{
+MockServer::MockServer(const api::Context& ot, const Settings& settings)
+    : settings_(settings)
+    , padding_(settings_.padding_, 'x')
+    , lock_()
+    , signal_()
+    , queued_()
+    , queue_()
+    , peer_()
+    , running_(false)
+    , next_session_(0)
+    , callback_(zmq::ListenCallback::Factory(
+          std::bind(&MockServer::callback, this, std::placeholders::_1)))
+    , socket_(ot.ZMQ().RouterSocket(
+          callback_,
+          zmq::socket::Socket::Direction::Bind))
+    , sender_()
+    , pusher_()
+    , random_(std::random_device{}())
+{
+}
+
+void MockServer::callback(zmq::Message& in)
+{
+    if (1 != in.Body().size()) {
+        LogOutput(__FUNCTION__)(": Invalid request.").Flush();
+
+        return;
+    }
+
+    const auto command = proto::Factory<proto::RPCCommand>(in.Body_at(0));
+
+    if (false == proto::Validate(command, VERBOSE)) {
+        LogOutput(__FUNCTION__)(": Invalid RPCCommand.").Flush();
+
+        return;
+    }
+
+    std::map<std::string, std::int32_t> tasks{};
+    auto reply = zmq::Message::ReplyFactory(in);
+    reply->AddFrame(respond(command, tasks));
+    const auto due = Clock::now() + settings_.latency_;
+
+    {
+        Lock lock(lock_);
+        peer_ = std::make_unique<OTZMQMessage>(zmq::Message::ReplyFactory(in));
+    }
+
+    enqueue(due, std::move(reply));
+
+    for (const auto& [task, instance] : tasks) {
+        proto::RPCPush push{};
+        push.set_version(MOCK_VERSION);
+        push.set_type(proto::RPCPUSH_TASK);
+        push.set_id(command.owner().empty() ? random_id() : command.owner());
+        auto& complete = *push.mutable_taskcomplete();
+        complete.set_version(MOCK_VERSION);
+        complete.set_id(task);
+        complete.set_result(true);
+        this->push(push, instance, due + settings_.task_delay_);
+    }
+}
+
+void MockServer::enqueue(const Clock::time_point due, OTZMQMessage&& message)
+{
+    {
+        Lock lock(lock_);
+        queue_.emplace(due, std::move(message));
+    }
+
+    queued_.notify_one();
+}
+
+bool MockServer::push(
+    const proto::RPCPush& push,
+    const std::int32_t instance,
+    const Clock::time_point due)
+{
+    std::unique_ptr<OTZMQMessage> message{};
+
+    {
+        Lock lock(lock_);
+
+        if (false == bool(peer_)) { return false; }
+
+        message = std::make_unique<OTZMQMessage>(*peer_);
+    }
+
+    auto& out = *message;
+    out->AddFrame(std::string("PUSH"));
+    out->AddFrame(push);
+    out->AddFrame(&instance, sizeof(instance));
+    enqueue(due, std::move(out));
+
+    return true;
+}
+
+void MockServer::push_loop()
+{
+    if (0 >= settings_.push_rate_) { return; }
+
+    const auto interval = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(1.0 / settings_.push_rate_));
+    auto next = Clock::now();
+
+    while (true) {
+        next += interval;
+
+        {
+            Lock lock(lock_);
+
+            if (signal_.wait_until(
+                    lock, next, [&] { return false == running_.load(); })) {
+                return;
+            }
+        }
+
+        proto::RPCPush push{};
+        push.set_version(MOCK_VERSION);
+        push.set_type(proto::RPCPUSH_ACCOUNT);
+        push.set_id(random_id());
+        auto& event = *push.mutable_accountevent();
+        event.set_version(MOCK_ACCOUNT_EVENT_VERSION);
+        event.set_id(random_id());
+        event.set_type(proto::ACCOUNTEVENT_INCOMINGTRANSFER);
+        event.set_contact(random_id());
+        event.set_workflow(random_id());
+        event.set_amount(MOCK_AMOUNT);
+        event.set_pendingamount(MOCK_AMOUNT);
+        event.set_timestamp(std::time(nullptr));
+        event.set_memo(padding_);
+        event.set_uuid(random_id());
+        this->push(push, 0, Clock::now());
+    }
+}
+
+std::string MockServer::random_id() { return Identifier::Random()->str(); }
+
+proto::RPCResponse MockServer::respond(
+    const proto::RPCCommand& in,
+    std::map<std::string, std::int32_t>& tasks)
+{
+    proto::RPCResponse output{};
+    output.set_version(in.version());
+    output.set_cookie(in.cookie());
+    output.set_type(in.type());
+    output.set_session(in.session());
+    const auto status = [&](const proto::RPCResponseCode code,
+                            const int index = 0) {
+        auto& item = *output.add_status();
+        item.set_version(MOCK_VERSION);
+        item.set_index(static_cast<std::uint32_t>(index));
+        item.set_code(code);
+    };
+    const auto queue = [&](const int index = 0) {
+        status(proto::RPCRESPONSE_QUEUED, index);
+        auto& task = *output.add_task();
+        task.set_version(MOCK_VERSION);
+        task.set_index(static_cast<std::uint32_t>(index));
+        task.set_id(random_id());
+        tasks.emplace(task.id(), in.session());
+    };
+    const auto list = [&]() {
+        status(proto::RPCRESPONSE_SUCCESS);
+
+        for (std::size_t i{0}; i < settings_.items_; ++i) {
+            output.add_identifier(random_id());
+        }
+    };
+
+    const auto draw = std::uniform_real_distribution<double>(0, 1)(random_);
+
+    if (draw < settings_.retry_rate_) {
+        status(proto::RPCRESPONSE_RETRY);
+
+        return output;
+    }
+
+    if (draw < settings_.retry_rate_ + settings_.bad_session_rate_) {
+        status(proto::RPCRESPONSE_BAD_SESSION);
+
+        return output;
+    }
+
+    switch (in.type()) {
+        case proto::RPCCOMMAND_ADDCLIENTSESSION:
+        case proto::RPCCOMMAND_ADDSERVERSESSION: {
+            status(proto::RPCRESPONSE_SUCCESS);
+            output.set_session(next_session_++);
+        } break;
+        case proto::RPCCOMMAND_LISTCLIENTSESSIONS:
+        case proto::RPCCOMMAND_LISTSERVERSESSIONS: {
+            status(proto::RPCRESPONSE_SUCCESS);
+
+            for (std::int32_t i{0}; i < next_session_; ++i) {
+                auto& session = *output.add_sessions();
+                session.set_version(MOCK_VERSION);
+                session.set_instance(i);
+            }
+        } break;
+        case proto::RPCCOMMAND_LISTHDSEEDS:
+        case proto::RPCCOMMAND_LISTNYMS:
+        case proto::RPCCOMMAND_LISTSERVERCONTRACTS:
+        case proto::RPCCOMMAND_LISTUNITDEFINITIONS:
+        case proto::RPCCOMMAND_LISTACCOUNTS:
+        case proto::RPCCOMMAND_LISTCONTACTS:
+        case proto::RPCCOMMAND_GETCOMPATIBLEACCOUNTS: {
+            list();
+        } break;
+        case proto::RPCCOMMAND_GETACCOUNTBALANCE: {
+            for (int i{0}; i < in.identifier_size(); ++i) {
+                status(proto::RPCRESPONSE_SUCCESS, i);
+                auto& balance = *output.add_balance();
+                balance.set_version(MOCK_VERSION);
+                balance.set_id(in.identifier(i));
+                balance.set_label(padding_);
+                balance.set_unit(random_id());
+                balance.set_owner(random_id());
+                balance.set_issuer(random_id());
+                balance.set_balance(MOCK_BALANCE);
+                balance.set_pendingbalance(MOCK_BALANCE);
+                balance.set_type(proto::ACCOUNTTYPE_NORMAL);
+            }
+        } break;
+        case proto::RPCCOMMAND_GETACCOUNTACTIVITY: {
+            for (int i{0}; i < in.identifier_size(); ++i) {
+                status(proto::RPCRESPONSE_SUCCESS, i);
+
+                for (std::size_t j{0}; j < settings_.items_; ++j) {
+                    auto& event = *output.add_accountevent();
+                    event.set_version(MOCK_ACCOUNT_EVENT_VERSION);
+                    event.set_id(in.identifier(i));
+                    event.set_type(proto::ACCOUNTEVENT_INCOMINGTRANSFER);
+                    event.set_contact(random_id());
+                    event.set_workflow(random_id());
+                    event.set_amount(MOCK_AMOUNT);
+                    event.set_pendingamount(MOCK_AMOUNT);
+                    event.set_timestamp(std::time(nullptr));
+                    event.set_memo(padding_);
+                    event.set_uuid(random_id());
+                }
+            }
+        } break;
+        case proto::RPCCOMMAND_CREATENYM:
+        case proto::RPCCOMMAND_CREATEUNITDEFINITION:
+        case proto::RPCCOMMAND_ADDCONTACT: {
+            status(proto::RPCRESPONSE_SUCCESS);
+            output.add_identifier(random_id());
+        } break;
+        case proto::RPCCOMMAND_REGISTERNYM:
+        case proto::RPCCOMMAND_ISSUEUNITDEFINITION:
+        case proto::RPCCOMMAND_CREATEACCOUNT:
+        case proto::RPCCOMMAND_CREATECOMPATIBLEACCOUNT:
+        case proto::RPCCOMMAND_SENDPAYMENT:
+        case proto::RPCCOMMAND_MOVEFUNDS: {
+            queue();
+        } break;
+        case proto::RPCCOMMAND_ACCEPTPENDINGPAYMENTS: {
+            for (int i{0}; i < in.acceptpendingpayment_size(); ++i) {
+                queue(i);
+            }
+        } break;
+        case proto::RPCCOMMAND_GETWORKFLOW: {
+            // A cheque which was written, sent and deposited, repeated until
+            // the workflow has items_ events. Every seventh event failed.
+            const proto::PaymentEventType cycle[] = {
+                proto::PAYMENTEVENTTYPE_CREATE,
+                proto::PAYMENTEVENTTYPE_CONVEY,
+                proto::PAYMENTEVENTTYPE_ACCEPT,
+                proto::PAYMENTEVENTTYPE_COMPLETE,
+            };
+            const auto now = static_cast<std::int64_t>(std::time(nullptr));
+
+            for (int i{0}; i < in.getworkflow_size(); ++i) {
+                status(proto::RPCRESPONSE_SUCCESS, i);
+                const auto& request = in.getworkflow(i);
+                auto& workflow = *output.add_workflow();
+                workflow.set_version(MOCK_VERSION);
+                workflow.set_id(request.workflowid());
+                workflow.set_type(proto::PAYMENTWORKFLOWTYPE_OUTGOINGCHEQUE);
+                workflow.set_notary(random_id());
+                workflow.add_party(request.nymid());
+                workflow.add_unit(random_id());
+                workflow.add_account(random_id());
+                const auto events = std::max<std::size_t>(settings_.items_, 1);
+                const auto first = now - static_cast<std::int64_t>(
+                                             events * MOCK_EVENT_INTERVAL);
+
+                for (std::size_t j{0}; j < events; ++j) {
+                    auto& event = *workflow.add_event();
+                    event.set_version(MOCK_VERSION);
+                    event.set_type(cycle[j % 4]);
+                    event.add_item(padding_);
+                    event.set_time(
+                        first + static_cast<std::int64_t>(
+                                    j * MOCK_EVENT_INTERVAL));
+                    event.set_nym(request.nymid());
+                    event.set_success(6 != j % 7);
+                }
+
+                const auto last = (events - 1) % 4;
+                workflow.set_state(
+                    (3 == last) ? proto::PAYMENTWORKFLOWSTATE_COMPLETED
+                    : (2 == last) ? proto::PAYMENTWORKFLOWSTATE_ACCEPTED
+                    : (1 == last) ? proto::PAYMENTWORKFLOWSTATE_CONVEYED
+                                  : proto::PAYMENTWORKFLOWSTATE_UNSENT);
+                workflow.set_archived(3 == last);
+            }
+        } break;
+        case proto::RPCCOMMAND_GETNYM: {
+            for (int i{0}; i < in.identifier_size(); ++i) {
+                status(proto::RPCRESPONSE_SUCCESS, i);
+                auto& nym = *output.add_nym();
+                nym.set_version(MOCK_VERSION);
+                nym.set_nymid(in.identifier(i));
+                nym.set_revision(1);
+            }
+        } break;
+        case proto::RPCCOMMAND_GETUNITDEFINITION: {
+            for (int i{0}; i < in.identifier_size(); ++i) {
+                status(proto::RPCRESPONSE_SUCCESS, i);
+                auto& unit = *output.add_unit();
+                unit.set_version(MOCK_VERSION);
+                unit.set_id(in.identifier(i));
+                unit.set_nymid(random_id());
+                unit.set_name("Mock units" + padding_);
+                unit.set_shortname("MCK");
+                unit.set_terms(padding_);
+            }
+        } break;
+        case proto::RPCCOMMAND_GETPENDINGPAYMENTS: {
+            status(proto::RPCRESPONSE_SUCCESS);
+
+            for (std::size_t i{0}; i < settings_.items_; ++i) {
+                auto& event = *output.add_accountevent();
+                event.set_version(MOCK_ACCOUNT_EVENT_VERSION);
+                event.set_id(random_id());
+                event.set_type(proto::ACCOUNTEVENT_INCOMINGCHEQUE);
+                event.set_contact(random_id());
+                event.set_workflow(random_id());
+                event.set_pendingamount(MOCK_AMOUNT);
+                event.set_timestamp(std::time(nullptr));
+                event.set_memo(padding_);
+            }
+        } break;
+        case proto::RPCCOMMAND_GETTRANSACTIONDATA: {
+            for (int i{0}; i < in.identifier_size(); ++i) {
+                status(proto::RPCRESPONSE_SUCCESS, i);
+                auto& data = *output.add_transactiondata();
+                data.set_version(MOCK_VERSION);
+                data.set_uuid(in.identifier(i));
+                data.set_type(proto::ACCOUNTEVENT_OUTGOINGTRANSFER);
+                data.add_sourceaccounts(random_id());
+                data.add_destinationaccounts(random_id());
+                data.set_amount(MOCK_AMOUNT);
+                data.set_state(proto::PAYMENTWORKFLOWSTATE_COMPLETED);
+            }
+        } break;
+        case proto::RPCCOMMAND_GETHDSEED:
+        case proto::RPCCOMMAND_GETSERVERCONTRACT:
+        case proto::RPCCOMMAND_GETCONTACT:
+        case proto::RPCCOMMAND_GETCONTACTACTIVITY: {
+            status(proto::RPCRESPONSE_NONE);
+        } break;
+        default: {
+            status(proto::RPCRESPONSE_SUCCESS);
+        }
+    }
+
+    return output;
+}
+
+void MockServer::send_loop()
+{
+    while (true) {
+        Lock lock(lock_);
+        queued_.wait(lock, [&] {
+            return (false == running_.load()) || (false == queue_.empty());
+        });
+
+        if (false == running_.load()) { return; }
+
+        const auto due = queue_.begin()->first;
+
+        if (Clock::now() < due) {
+            queued_.wait_until(lock, due);
+
+            continue;
+        }
+
+        auto message = std::move(queue_.begin()->second);
+        queue_.erase(queue_.begin());
+        lock.unlock();
+        socket_->Send(message);
+    }
+}
+
+bool MockServer::Start()
+{
+    if (false == settings_.private_key_.empty()) {
+        if (false == socket_->SetPrivateKey(settings_.private_key_)) {
+            LogOutput(__FUNCTION__)(": Invalid private key").Flush();
+
+            return false;
+        }
+    }
+
+    if (false == socket_->Start(settings_.endpoint_)) {
+        LogOutput(__FUNCTION__)(": Unable to bind ")(settings_.endpoint_)
+            .Flush();
+
+        return false;
+    }
+
+    running_.store(true);
+    sender_ = std::thread(&MockServer::send_loop, this);
+    pusher_ = std::thread(&MockServer::push_loop, this);
+
+    return true;
+}
+
+MockServer::~MockServer()
+{
+    {
+        Lock lock(lock_);
+        running_.store(false);
+    }
+
+    signal_.notify_all();
+    queued_.notify_all();
+
+    if (pusher_.joinable()) { pusher_.join(); }
+
+    if (sender_.joinable()) { sender_.join(); }
+
+    socket_->Close();
+}
+}  // namespace opentxs::otctl
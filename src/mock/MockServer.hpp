@@ -0,0 +1,99 @@
+// Copyright (c) 2019 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <opentxs/opentxs.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+
+namespace opentxs::otctl
+{
+// Stand-in for otagent which answers RPC commands with synthetic data
+//
+// Replies are well formed but carry random identifiers. Commands which
+// otagent would queue are answered with a task ID and followed by a task
+// completion push. Nyms, unit definitions and workflows are fabricated with
+// the fields otctl reads but carry no signatures. Seeds, server contracts and
+// contacts are answered with RPCRESPONSE_NONE. A configurable share of
+// commands can be refused with RETRY or BAD_SESSION to exercise client side
+// retries.
+class MockServer
+{
+public:
+    struct Settings {
+        std::string endpoint_{};
+        // Z85 encoded CURVE private key matching the client's server_pubkey
+        std::string private_key_{};
+        // Entries in list replies and events per account in activity replies
+        std::size_t items_{10};
+        // Bytes of padding in every label and memo
+        std::size_t padding_{0};
+        std::chrono::microseconds latency_{0};
+        std::chrono::microseconds task_delay_{100000};
+        // Unsolicited account event pushes per second
+        double push_rate_{0};
+        // Share of commands, between 0 and 1, refused with each status
+        double retry_rate_{0};
+        double bad_session_rate_{0};
+    };
+
+    bool Start();
+
+    MockServer(const api::Context& ot, const Settings& settings);
+
+    ~MockServer();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    const Settings settings_;
+    const std::string padding_;
+    std::mutex lock_;
+    // Wakes push_loop at shutdown
+    std::condition_variable signal_;
+    // Wakes send_loop when a message is queued
+    std::condition_variable queued_;
+    std::multimap<Clock::time_point, OTZMQMessage> queue_;
+    std::unique_ptr<OTZMQMessage> peer_;
+    std::atomic<bool> running_;
+    std::atomic<std::int32_t> next_session_;
+    OTZMQListenCallback callback_;
+    OTZMQRouterSocket socket_;
+    std::thread sender_;
+    std::thread pusher_;
+    // Only used by respond(), which runs on the socket thread
+    std::minstd_rand random_;
+
+    static std::string random_id();
+
+    void callback(network::zeromq::Message& in);
+    void enqueue(const Clock::time_point due, OTZMQMessage&& message);
+    bool push(
+        const proto::RPCPush& push,
+        const std::int32_t instance,
+        const Clock::time_point due);
+    void push_loop();
+    proto::RPCResponse respond(
+        const proto::RPCCommand& in,
+        std::map<std::string, std::int32_t>& tasks);
+    void send_loop();
+
+    MockServer() = delete;
+    MockServer(const MockServer&) = delete;
+    MockServer(MockServer&&) = delete;
+    MockServer& operator=(const MockServer&) = delete;
+    MockServer& operator=(MockServer&&) = delete;
+};
+}  // namespace opentxs::otctl
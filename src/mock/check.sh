@@ -0,0 +1,105 @@
+#!/bin/sh
+# Copyright (c) 2019 The Open-Transactions developers
+# This Source Code Form is subject to the terms of the Mozilla Public
+# License, v. 2.0. If a copy of the MPL was not distributed with this
+# file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+# Usage: check.sh <otctl> <otctl-mock>
+#
+# Runs one-shot otctl commands against otctl-mock and fails if any of them
+# exits with an unexpected status. The second pass refuses a share of the
+# commands with RETRY so the resend path is exercised as well.
+
+OTCTL="$1"
+MOCK="$2"
+
+if [ -z "$OTCTL" ] || [ -z "$MOCK" ]; then
+    echo "Usage: $0 <otctl> <otctl-mock>" >&2
+    exit 2
+fi
+
+DIR="$(mktemp -d)"
+ENDPOINT="ipc://$DIR/mock.sock"
+MOCK_PID=""
+FAILED=0
+
+cleanup() {
+    if [ -n "$MOCK_PID" ]; then
+        kill "$MOCK_PID" 2>/dev/null
+        wait "$MOCK_PID" 2>/dev/null
+    fi
+
+    MOCK_PID=""
+}
+
+trap 'cleanup; rm -rf "$DIR"' EXIT
+trap 'exit 1' INT TERM
+
+# Plaintext sockets on both ends
+echo '{"otagent":{}}' > "$DIR/otagent.key"
+
+start_mock() {
+    cleanup
+    rm -f "$DIR/mock.sock"
+    "$MOCK" --endpoint "$ENDPOINT" --items 5 --taskdelay 10 "$@" \
+        > "$DIR/mock.log" 2>&1 &
+    MOCK_PID=$!
+    tries=0
+
+    while [ ! -S "$DIR/mock.sock" ]; do
+        tries=$((tries + 1))
+
+        if [ "$tries" -gt 50 ]; then
+            echo "FAIL: otctl-mock did not bind $ENDPOINT" >&2
+            cat "$DIR/mock.log" >&2
+            exit 1
+        fi
+
+        sleep 0.1
+    done
+}
+
+# expect <status> <otctl arguments...>
+expect() {
+    want="$1"
+    shift
+    "$OTCTL" --keyfile "$DIR/otagent.key" --endpoint "$ENDPOINT" "$@" \
+        > "$DIR/otctl.log" 2>&1
+    got=$?
+
+    if [ "$want" = "0" ] && [ "$got" -ne 0 ]; then
+        echo "FAIL: otctl $* exited $got" >&2
+        cat "$DIR/otctl.log" >&2
+        FAILED=1
+    elif [ "$want" != "0" ] && [ "$got" -eq 0 ]; then
+        echo "FAIL: otctl $* succeeded, expected an error" >&2
+        FAILED=1
+    else
+        echo "ok: otctl $*"
+    fi
+}
+
+NYM="ot2mocknym"
+ACCOUNT="ot2mockaccount"
+
+start_mock
+expect 0 listaccounts --instance 0
+expect 0 balances --instance 0
+expect 0 snapshot --instance 0 --file "$DIR/snapshot.ndjson"
+expect 0 workflowstats --instance 0 --nym "$NYM" --account "$ACCOUNT"
+# Mock balances never match the sum of the mock activity
+expect 1 reconcile --instance 0 --account "$ACCOUNT"
+expect 1 reconcile --account "$ACCOUNT"
+expect 1 bogus
+
+if [ ! -s "$DIR/snapshot.ndjson" ]; then
+    echo "FAIL: snapshot wrote nothing" >&2
+    FAILED=1
+fi
+
+start_mock --retryrate 0.3
+expect 0 --retries 20 balances --instance 0
+expect 0 --retries 20 workflowstats --instance 0 --nym "$NYM" \
+    --account "$ACCOUNT"
+
+exit "$FAILED"
@@ -0,0 +1,104 @@
+// Copyright (c) 2019 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <opentxs/opentxs.hpp>
+
+#include <boost/program_options.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "MockServer.hpp"
+
+namespace po = boost::program_options;
+
+namespace
+{
+std::atomic<bool> shutdown_{false};
+
+void handle_signal(int) { shutdown_.store(true); }
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    opentxs::otctl::MockServer::Settings settings{};
+    std::int64_t latency{0};
+    std::int64_t taskDelay{100};
+
+    auto options = po::options_description{"otctl-mock"};
+    options.add_options()(
+        "endpoint",
+        po::value<std::string>(&settings.endpoint_)
+            ->default_value("ipc:///tmp/otctl-mock.sock"),
+        "Endpoint to bind")(
+        "privkey",
+        po::value<std::string>(&settings.private_key_),
+        "Z85 encoded CURVE private key matching the client's server_pubkey")(
+        "items",
+        po::value<std::size_t>(&settings.items_)->default_value(10),
+        "Entries per list reply and events per account")(
+        "padding",
+        po::value<std::size_t>(&settings.padding_)->default_value(0),
+        "Bytes of padding in every label and memo")(
+        "latency",
+        po::value<std::int64_t>(&latency)->default_value(0),
+        "Microseconds to delay every reply")(
+        "taskdelay",
+        po::value<std::int64_t>(&taskDelay)->default_value(100),
+        "Milliseconds between a queued reply and its task completion push")(
+        "pushrate",
+        po::value<double>(&settings.push_rate_)->default_value(0),
+        "Unsolicited account event pushes per second")(
+        "retryrate",
+        po::value<double>(&settings.retry_rate_)->default_value(0),
+        "Share of commands, between 0 and 1, answered with RETRY")(
+        "badsessionrate",
+        po::value<double>(&settings.bad_session_rate_)->default_value(0),
+        "Share of commands, between 0 and 1, answered with BAD_SESSION");
+    auto variables = po::variables_map{};
+
+    try {
+        po::store(po::parse_command_line(argc, argv, options), variables);
+        po::notify(variables);
+    } catch (const po::error& e) {
+        std::cerr << "ERROR: " << e.what() << "\n\n" << options << std::endl;
+
+        return 1;
+    }
+
+    settings.latency_ = std::chrono::microseconds{latency};
+    settings.task_delay_ = std::chrono::milliseconds{taskDelay};
+    std::signal(SIGINT, handle_signal);
+    std::signal(SIGTERM, handle_signal);
+    const auto& ot = opentxs::InitContext();
+    auto mock = std::make_unique<opentxs::otctl::MockServer>(ot, settings);
+
+    if (false == mock->Start()) {
+        mock.reset();
+        opentxs::Cleanup();
+        opentxs::Join();
+
+        return 1;
+    }
+
+    opentxs::LogNormal("Listening on ")(settings.endpoint_).Flush();
+
+    while (false == shutdown_.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+
+    opentxs::LogNormal("Shutting down...").Flush();
+    mock.reset();
+    opentxs::Cleanup();
+    opentxs::Join();
+
+    return 0;
+}